@@ -0,0 +1,226 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+// Benchmark of the page renders, the series of the data endpoints and the list
+// APIs on a synthetic data set.
+//
+// Usage: bench [--iterations=N] [--years=N] [--accounts=N] [--expenses=N] [--assets=N] [--shares=N]
+//
+// The size is the number of bytes of the pages and the APIs, and the number of
+// daily values of the series.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <vector>
+
+#include "bench_data.hpp"
+
+#include "api/assets_api.hpp"
+#include "api/expenses_api.hpp"
+#include "pages/html_writer.hpp"
+#include "pages/index_pages.hpp"
+#include "pages/net_worth_pages.hpp"
+#include "pages/output_buffer.hpp"
+#include "pages/overview_pages.hpp"
+#include "pages/time_series.hpp"
+
+#include "data_cache.hpp"
+#include "http.hpp"
+#include "logging.hpp"
+#include "utils.hpp"
+
+namespace {
+
+std::atomic<size_t> allocations     = 0;
+std::atomic<size_t> allocated_bytes = 0;
+
+} // end of anonymous namespace
+
+// Count all the allocations of the process
+
+void* operator new(size_t size) {
+    ++allocations;
+    allocated_bytes += size;
+
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t /*size*/) noexcept {
+    std::free(p);
+}
+
+using namespace budget;
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+// Run one iteration of a benchmark, returns the size of the output
+using bench_function = std::function<size_t()>;
+
+void run_bench(std::string_view name, size_t iterations, const bench_function& function) {
+    // The first run fills the caches of the data
+    function();
+
+    double total = 0.0;
+    double best  = 0.0;
+    size_t size  = 0;
+
+    const size_t start_allocations = allocations;
+    const size_t start_bytes       = allocated_bytes;
+
+    for (size_t i = 0; i < iterations; ++i) {
+        const auto start = clock_type::now();
+
+        size = function();
+
+        const double elapsed = std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+
+        total += elapsed;
+        best = i ? std::min(best, elapsed) : elapsed;
+    }
+
+    const double count = static_cast<double>(std::max<size_t>(iterations, 1));
+
+    std::cout << std::format("{:<32} {:>10.3f} {:>10.3f} {:>12.0f} {:>12.0f} {:>10}\n",
+                             name,
+                             total / count,
+                             best,
+                             static_cast<double>(allocations - start_allocations) / count,
+                             static_cast<double>(allocated_bytes - start_bytes) / count / 1024.0,
+                             size);
+}
+
+template <typename... Args>
+bench_function page_bench(void (*page)(html_writer&, Args...)) {
+    return [page]() {
+        budget::output_buffer out;
+        budget::html_writer   w(out);
+
+        if constexpr (sizeof...(Args) == 0) {
+            page(w);
+        } else {
+            const httplib::Request req;
+            page(w, req);
+        }
+
+        return out.size();
+    };
+}
+
+// The series are computed from a cache whose views are already computed, as the
+// data endpoints do with the snapshot of their worker
+bench_function serie_bench(daily_serie (*serie)(data_cache&)) {
+    return [serie, cache = std::make_shared<data_cache>()]() { return serie(*cache).size(); };
+}
+
+bench_function series_bench(std::vector<daily_serie> (*series)(data_cache&, bool), bool portfolio) {
+    return [series, portfolio, cache = std::make_shared<data_cache>()]() {
+        size_t size = 0;
+
+        for (const auto& serie : series(*cache, portfolio)) {
+            size += serie.size();
+        }
+
+        return size;
+    };
+}
+
+bench_function api_bench(void (*api)(const httplib::Request&, httplib::Response&)) {
+    return [api]() {
+        const httplib::Request req;
+        httplib::Response      res;
+
+        api(req, res);
+
+        // The list APIs stream their content
+        if (!res.content_provider_) {
+            return res.body.size();
+        }
+
+        size_t size = 0;
+        bool   done = false;
+
+        httplib::DataSink sink;
+        sink.write = [&size](const char* /*data*/, size_t length) {
+            size += length;
+            return true;
+        };
+        sink.done        = [&done]() { done = true; };
+        sink.is_writable = []() { return true; };
+
+        while (!done && res.content_provider_(size, 0, sink)) {}
+
+        if (res.content_provider_resource_releaser_) {
+            res.content_provider_resource_releaser_(done);
+        }
+
+        return size;
+    };
+}
+
+} // end of anonymous namespace
+
+int main(int argc, char** argv) {
+    loguru::g_stderr_verbosity = loguru::Verbosity_WARNING;
+    loguru::init(argc, argv);
+
+    size_t iterations = 10;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::string_view arg(argv[i]); arg.starts_with("--iterations=")) {
+            iterations = to_number<size_t>(std::string(arg.substr(13)));
+        }
+    }
+
+    const auto directory = setup_bench_environment();
+
+    const auto generation_start = clock_type::now();
+    generate_bench_data(parse_bench_data_size(argc, argv));
+    const auto generation_time = std::chrono::duration<double>(clock_type::now() - generation_start).count();
+
+    std::cout << std::format("Generated the data in {:.3f}s, {} iterations per benchmark\n\n", generation_time, iterations);
+    std::cout << std::format("{:<32} {:>10} {:>10} {:>12} {:>12} {:>10}\n", "benchmark", "mean (ms)", "min (ms)", "allocs", "alloc (KiB)", "size");
+
+    run_bench("index_page", iterations, page_bench(&index_page));
+    run_bench("net_worth_graph_page", iterations, page_bench(&net_worth_graph_page));
+    run_bench("net_worth_allocation_page", iterations, page_bench(&net_worth_allocation_page));
+    run_bench("overview_year_page", iterations, page_bench(&overview_year_page));
+    run_bench("time_graph_savings_rate_page", iterations, page_bench(&time_graph_savings_rate_page));
+    run_bench("portfolio_allocation_page", iterations, page_bench(&portfolio_allocation_page));
+
+    run_bench("net_worth_serie", iterations, serie_bench(&net_worth_serie));
+    run_bench("fi_net_worth_serie", iterations, serie_bench(&fi_net_worth_serie));
+    run_bench("portfolio_serie", iterations, serie_bench(&portfolio_serie));
+    run_bench("net_worth_allocation_series", iterations, series_bench(&asset_class_series, false));
+    run_bench("portfolio_allocation_series", iterations, series_bench(&asset_class_series, true));
+
+    run_bench("list_expenses_api", iterations, api_bench(&list_expenses_api));
+    run_bench("list_asset_values_api", iterations, api_bench(&list_asset_values_api));
+    run_bench("list_asset_shares_api", iterations, api_bench(&list_asset_shares_api));
+
+    std::filesystem::remove_all(directory);
+
+    return 0;
+}
@@ -0,0 +1,240 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "bench_data.hpp"
+#include "pages/time_series.hpp"
+
+#include "accounts.hpp"
+#include "assets.hpp"
+#include "config.hpp"
+#include "earnings.hpp"
+#include "expenses.hpp"
+#include "guid.hpp"
+#include "logging.hpp"
+#include "share.hpp"
+#include "utils.hpp"
+
+using namespace budget;
+
+namespace {
+
+// The share-based assets are spread over a few tickers
+constexpr size_t bench_tickers = 8;
+
+// A random amount between min and max, with cents
+budget::money random_amount(std::mt19937_64& generator, size_t min, size_t max) {
+    std::uniform_int_distribution<size_t> cents(min * 100, max * 100);
+    const auto value = cents(generator);
+    return budget::money_from_string(std::format("{}.{:02}", value / 100, value % 100));
+}
+
+} // end of anonymous namespace
+
+std::string budget::setup_bench_environment() {
+    auto directory = std::filesystem::temp_directory_path() / std::format("budget_bench_{}", ::getpid());
+
+    std::filesystem::create_directories(directory / ".budget");
+
+    // The configuration and the data are read relative to the home
+    ::setenv("HOME", directory.c_str(), 1);
+
+    if (!load_config()) {
+        LOG_F(ERROR, "Could not load the configuration of the benchmark");
+        std::exit(1);
+    }
+
+    return directory.string();
+}
+
+void budget::generate_bench_data(const bench_data_size& size) {
+    // Always the same data for comparable runs
+    std::mt19937_64 generator(42);
+
+    const auto today = budget::local_day();
+    const auto start = budget::date(today.year() - date_type(size.years), 1, 1);
+
+    const auto currency = get_default_currency();
+
+    // 1. The accounts, with expenses every day and a salary every month
+
+    std::vector<size_t> accounts;
+
+    for (size_t i = 0; i < size.accounts; ++i) {
+        account account;
+        account.guid          = budget::generate_guid();
+        account.name          = std::format("Account {}", i);
+        account.amount        = random_amount(generator, 100, 1000);
+        account.since         = start;
+        account.until         = budget::date(2099, 12, 31);
+        account.hide_if_empty = false;
+
+        accounts.push_back(add_account(std::move(account)));
+    }
+
+    std::uniform_int_distribution<size_t> account_distribution(0, accounts.size() - 1);
+
+    for (auto date = start; date <= today; date += days(1)) {
+        for (size_t i = 0; i < size.expenses_per_day; ++i) {
+            expense expense;
+            expense.guid    = budget::generate_guid();
+            expense.date    = date;
+            expense.account = accounts[account_distribution(generator)];
+            expense.name    = std::format("Expense {}", i);
+            expense.amount  = random_amount(generator, 1, 200);
+
+            add_expense(std::move(expense));
+        }
+
+        if (date.day() == 1) {
+            earning earning;
+            earning.guid    = budget::generate_guid();
+            earning.date    = date;
+            earning.account = accounts.front();
+            earning.name    = "Salary";
+            earning.amount  = random_amount(generator, 5000, 8000);
+
+            add_earning(std::move(earning));
+        }
+    }
+
+    // 2. The asset classes and the assets, with a value every week
+
+    std::vector<size_t> classes;
+
+    for (std::string_view name : {"Stocks", "Bonds", "Cash", "Real Estate"}) {
+        asset_class asset_class;
+        asset_class.guid = budget::generate_guid();
+        asset_class.name = std::string(name);
+        asset_class.fi   = name != "Real Estate";
+
+        add_asset_class(asset_class);
+
+        classes.push_back(asset_class.id);
+    }
+
+    std::vector<size_t> assets;
+    std::vector<size_t> share_assets;
+
+    for (size_t i = 0; i < size.assets; ++i) {
+        asset asset;
+        asset.guid = budget::generate_guid();
+        asset.name = std::format("Asset {}", i);
+
+        update_asset_class_allocation(asset, get_asset_class(classes[i % classes.size()]), money(100));
+
+        // The assets are in the default currency so that no exchange rate is
+        // fetched during the benchmarks. One in four is share-based.
+        asset.currency        = currency;
+        asset.portfolio       = i % 2 == 0;
+        asset.portfolio_alloc = money(0);
+        asset.share_based     = i % 4 == 3;
+        asset.active          = true;
+
+        if (asset.share_based) {
+            asset.ticker = std::format("BENCH{}", i % bench_tickers);
+        }
+
+        add_asset(asset);
+
+        assets.push_back(asset.id);
+
+        // The value of the share-based assets comes from their shares
+        if (asset.share_based) {
+            share_assets.push_back(asset.id);
+            continue;
+        }
+
+        auto value = random_amount(generator, 1000, 100000);
+
+        for (auto date = start; date <= today; date += days(7)) {
+            asset_value asset_value;
+            asset_value.guid      = budget::generate_guid();
+            asset_value.amount    = value;
+            asset_value.asset_id  = asset.id;
+            asset_value.set_date  = date;
+            asset_value.liability = false;
+
+            add_asset_value(asset_value);
+
+            value += random_amount(generator, 0, 500);
+        }
+    }
+
+    // 3. The share transactions, spread over the share-based assets and the period
+
+    if (share_assets.empty()) {
+        share_assets = assets;
+    }
+
+    std::uniform_int_distribution<size_t>  asset_distribution(0, share_assets.size() - 1);
+    std::uniform_int_distribution<int64_t> day_distribution(0, days_between(start, today));
+    std::uniform_int_distribution<int64_t> shares_distribution(-20, 50);
+
+    for (size_t i = 0; i < size.shares; ++i) {
+        asset_share asset_share;
+        asset_share.guid     = budget::generate_guid();
+        asset_share.asset_id = share_assets[asset_distribution(generator)];
+        asset_share.shares   = shares_distribution(generator);
+        asset_share.price    = random_amount(generator, 10, 500);
+        asset_share.date     = start + days(day_distribution(generator));
+
+        add_asset_share(asset_share);
+    }
+
+    // 4. The price of the tickers for every day, so that no share price is fetched
+
+    {
+        std::ofstream                          prices(std::filesystem::path(budget_folder()) / "share_price.cache");
+        std::uniform_real_distribution<double> first_price(10.0, 500.0);
+        std::normal_distribution<double>       daily_change(0.0003, 0.01);
+
+        for (size_t t = 0; t < bench_tickers; ++t) {
+            double price = first_price(generator);
+
+            for (auto date = start; date <= today; date += days(1)) {
+                prices << std::format("{}:BENCH{}:{:.2f}\n", budget::to_string(date), t, price);
+                price *= 1.0 + daily_change(generator);
+            }
+        }
+    }
+
+    load_share_price_cache();
+
+    LOG_F(INFO, "Generated {} years of data with {} accounts, {} assets and {} share transactions", size.years, size.accounts, size.assets, size.shares);
+}
+
+bench_data_size budget::parse_bench_data_size(int argc, char** argv) {
+    bench_data_size size;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg(argv[i]);
+
+        auto value = [&arg](std::string_view name, size_t& target) {
+            if (arg.starts_with(name)) {
+                target = to_number<size_t>(std::string(arg.substr(name.size())));
+            }
+        };
+
+        value("--years=", size.years);
+        value("--accounts=", size.accounts);
+        value("--expenses=", size.expenses_per_day);
+        value("--assets=", size.assets);
+        value("--shares=", size.shares);
+    }
+
+    return size;
+}
@@ -0,0 +1,36 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace budget {
+
+// The size of the synthetic data set
+struct bench_data_size {
+    size_t years            = 20;
+    size_t accounts         = 10;
+    size_t expenses_per_day = 3;
+    size_t assets           = 200;  // One in four share-based, the others with a value per week
+    size_t shares           = 5000; // Transactions of the share-based assets
+};
+
+// Point the home and the budget folder to a new temporary directory and load
+// the configuration from there, so that the benchmarks never touch the real data.
+// Returns the temporary directory.
+std::string setup_bench_environment();
+
+// Fill the in-memory data with a reproducible synthetic data set, ending today
+void generate_bench_data(const bench_data_size& size);
+
+// Parse the size from the command line (--years=N, --assets=N, ...), ignoring the
+// other arguments
+bench_data_size parse_bench_data_size(int argc, char** argv);
+
+} // end of namespace budget
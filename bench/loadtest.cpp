@@ -0,0 +1,274 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+// Load test of the complete server on a loopback port, on a synthetic data set.
+//
+// Usage: loadtest [--clients=N] [--requests=N] [--writes=PERCENT] [--years=N] [--assets=N] ...
+//
+// Each client sends its requests one after the other on a keep-alive connection,
+// picking a dashboard page, a data endpoint or a list API, or with the given
+// probability an add or an edit of an expense.
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "bench_data.hpp"
+
+#include "api/server_api.hpp"
+#include "pages/server_pages.hpp"
+#include "server_metrics.hpp"
+#include "server_pool.hpp"
+
+#include "accounts.hpp"
+#include "config.hpp"
+#include "expenses.hpp"
+#include "http.hpp"
+#include "logging.hpp"
+#include "utils.hpp"
+
+using namespace budget;
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr std::array read_routes{
+        "/",
+        "/overview/",
+        "/overview/year/",
+        "/expenses/",
+        "/net_worth/status/",
+        "/net_worth/graph/",
+        "/net_worth/allocation/",
+        "/portfolio/status/",
+        "/data/net_worth/daily/",
+        "/data/portfolio/allocation/",
+        "/api/expenses/list/",
+        "/api/asset_values/list/",
+};
+
+struct loadtest_config {
+    size_t clients  = 8;
+    size_t requests = 200; // Per client
+    size_t writes   = 5;   // Percentage of add/edit requests
+};
+
+struct client_result {
+    std::vector<double> latencies; // In milliseconds
+    size_t              reads        = 0;
+    size_t              read_errors  = 0;
+    size_t              writes       = 0;
+    size_t              write_errors = 0;
+    size_t              bytes        = 0;
+};
+
+loadtest_config parse_config(int argc, char** argv) {
+    loadtest_config config;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg(argv[i]);
+
+        auto value = [&arg](std::string_view name, size_t& target) {
+            if (arg.starts_with(name)) {
+                target = to_number<size_t>(std::string(arg.substr(name.size())));
+            }
+        };
+
+        value("--clients=", config.clients);
+        value("--requests=", config.requests);
+        value("--writes=", config.writes);
+    }
+
+    return config;
+}
+
+// The resident set size of the process, in KiB
+size_t current_rss() {
+    std::ifstream status("/proc/self/status");
+
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.starts_with("VmRSS:")) {
+            return to_number<size_t>(std::string(line.substr(6, line.find("kB") - 6)));
+        }
+    }
+
+    return 0;
+}
+
+size_t peak_rss() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+
+    return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * static_cast<double>(sorted.size())))];
+}
+
+client_result run_client(int port, size_t index, const loadtest_config& config, const std::vector<size_t>& expenses, size_t account) {
+    client_result result;
+    result.latencies.reserve(config.requests);
+
+    std::mt19937_64                       generator(index);
+    std::uniform_int_distribution<size_t> percent(0, 99);
+    std::uniform_int_distribution<size_t> route(0, read_routes.size() - 1);
+    std::uniform_int_distribution<size_t> expense(0, expenses.size() - 1);
+
+    httplib::Client client("127.0.0.1", port);
+    client.set_keep_alive(true);
+
+    const auto today = budget::to_string(budget::local_day());
+
+    for (size_t i = 0; i < config.requests; ++i) {
+        const auto start = clock_type::now();
+
+        httplib::Result response;
+
+        const bool write = percent(generator) < config.writes;
+
+        if (write) {
+            httplib::Params params{
+                    {"input_name", std::format("Load test {}-{}", index, i)},
+                    {"input_date", today},
+                    {"input_amount", "12.50"},
+                    {"input_account", budget::to_string(account)},
+            };
+
+            if (!expenses.empty() && i % 2) {
+                params.emplace("input_id", budget::to_string(expenses[expense(generator)]));
+                response = client.Post("/api/expenses/edit/", params);
+            } else {
+                response = client.Post("/api/expenses/add/", params);
+            }
+        } else {
+            response = client.Get(read_routes[route(generator)], {{"Accept-Encoding", "gzip"}});
+        }
+
+        result.latencies.push_back(std::chrono::duration<double, std::milli>(clock_type::now() - start).count());
+
+        // The API reports the failed actions with a success status
+        const bool failed = !response || response->status >= 400 || (write && response->body.starts_with("Error:"));
+
+        ++(write ? result.writes : result.reads);
+
+        if (failed) {
+            ++(write ? result.write_errors : result.read_errors);
+        } else {
+            result.bytes += response->body.size();
+        }
+    }
+
+    return result;
+}
+
+} // end of anonymous namespace
+
+int main(int argc, char** argv) {
+    loguru::g_stderr_verbosity = loguru::Verbosity_WARNING;
+    loguru::init(argc, argv);
+
+    const auto config    = parse_config(argc, argv);
+    const auto directory = setup_bench_environment();
+
+    generate_bench_data(parse_bench_data_size(argc, argv));
+
+    // The ids are taken before the server starts, the server may then modify the data
+    std::vector<size_t> expenses;
+    for (const auto& expense : all_expenses()) {
+        expenses.push_back(expense.id);
+    }
+
+    const size_t account = all_accounts().front().id;
+
+    set_server_running();
+
+    httplib::Server server;
+
+    configure_server_pool(server);
+
+    load_pages(server);
+    load_api(server);
+    install_request_metrics(server);
+
+    const int port = server.bind_to_any_port("127.0.0.1");
+
+    if (port < 0) {
+        LOG_F(ERROR, "Could not bind the load test server");
+        return 1;
+    }
+
+    std::jthread server_thread([&server]() { server.listen_after_bind(); });
+
+    server.wait_until_ready();
+
+    const size_t rss_before = current_rss();
+
+    std::cout << std::format("{} clients, {} requests per client, {}% writes\n", config.clients, config.requests, config.writes);
+
+    std::vector<client_result> results(config.clients);
+
+    const auto start = clock_type::now();
+
+    {
+        std::vector<std::jthread> clients;
+
+        for (size_t i = 0; i < config.clients; ++i) {
+            clients.emplace_back([&, i]() { results[i] = run_client(port, i, config, expenses, account); });
+        }
+    }
+
+    const double elapsed = std::chrono::duration<double>(clock_type::now() - start).count();
+
+    server.stop();
+    server_thread.join();
+
+    std::vector<double> latencies;
+    client_result       total;
+
+    for (const auto& result : results) {
+        latencies.insert(latencies.end(), result.latencies.begin(), result.latencies.end());
+        total.reads += result.reads;
+        total.read_errors += result.read_errors;
+        total.writes += result.writes;
+        total.write_errors += result.write_errors;
+        total.bytes += result.bytes;
+    }
+
+    const size_t errors = total.read_errors + total.write_errors;
+
+    std::ranges::sort(latencies);
+
+    std::cout << std::format("requests:   {} in {:.3f}s\n", latencies.size(), elapsed);
+    std::cout << std::format("errors:     {} of {} reads, {} of {} writes\n", total.read_errors, total.reads, total.write_errors, total.writes);
+    std::cout << std::format("throughput: {:.1f} requests/s, {:.1f} KiB/s\n", static_cast<double>(latencies.size()) / elapsed, static_cast<double>(total.bytes) / 1024.0 / elapsed);
+    std::cout << std::format("latency:    p50 {:.3f}ms, p95 {:.3f}ms, p99 {:.3f}ms, max {:.3f}ms\n",
+                             percentile(latencies, 0.50),
+                             percentile(latencies, 0.95),
+                             percentile(latencies, 0.99),
+                             latencies.empty() ? 0.0 : latencies.back());
+    std::cout << std::format("rss:        {} KiB before, {} KiB after, {} KiB peak\n", rss_before, current_rss(), peak_rss());
+
+    std::filesystem::remove_all(directory);
+
+    return errors ? 1 : 0;
+}
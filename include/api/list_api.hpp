@@ -0,0 +1,88 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "data.hpp"
+
+namespace httplib {
+struct Request;
+struct Response;
+}; // namespace httplib
+
+namespace budget {
+
+struct record_digest {
+    size_t hash;
+    size_t size; // The size of the serialized record
+};
+
+// Serialize the record at the given index to compute its digest
+using list_hasher = std::function<record_digest(size_t index)>;
+
+// Append the serialized record at the given index to the output
+using list_serializer = std::function<void(size_t index, std::string& output)>;
+
+// Send the records of a collection for the list API.
+//
+// The response always contains the current generation in the X-Budget-Generation
+// header. If the since parameter is set to a generation previously returned by the
+// list API of the same collection, only the records that changed since then are
+// sent, followed by one "deleted:<id>" line per deleted record. Any other value
+// (the generation of another collection, a generation from before a restart or
+// older than the changes remembered) gets all the records with X-Budget-Sync set
+// to full.
+//
+// The records are only hashed when the data changed since the previous list of the
+// collection. The content is streamed in chunks of bounded size, serialized on the
+// fly from the copies of the objects, and compressed if the client supports it.
+void api_list_content(const httplib::Request& req,
+                      httplib::Response&      res,
+                      std::string_view        collection,
+                      std::vector<size_t>     ids,
+                      list_hasher             hasher,
+                      list_serializer         serializer);
+
+template <typename Range>
+void api_list(const httplib::Request& req, httplib::Response& res, std::string_view collection, Range&& objects) {
+    using object_type = std::remove_cvref_t<std::ranges::range_value_t<Range>>;
+
+    // The copies must outlive the handler since the content is streamed afterwards
+    auto snapshot = std::make_shared<std::vector<object_type>>();
+
+    std::vector<size_t> ids;
+
+    for (auto& object : objects) {
+        snapshot->push_back(object);
+        ids.push_back(object.id);
+    }
+
+    auto serializer = [snapshot](size_t index, std::string& output) {
+        data_writer writer;
+        (*snapshot)[index].save(writer);
+        output += writer.to_string();
+        output += '\n';
+    };
+
+    auto hasher = [serializer](size_t index) {
+        std::string content;
+        serializer(index, content);
+        return record_digest{std::hash<std::string>{}(content), content.size()};
+    };
+
+    api_list_content(req, res, collection, std::move(ids), std::move(hasher), std::move(serializer));
+}
+
+} // end of namespace budget
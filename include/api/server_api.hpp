@@ -24,6 +24,8 @@ namespace budget {
 void load_api(httplib::Server& server);
 
 // For the API pages
+// Note: api_success is only used by actions and therefore invalidates the cached pages,
+// api_error only invalidates them when it is the failure of an action
 bool api_start(const httplib::Request& req, httplib::Response& res);
 void api_error(const httplib::Request& req, httplib::Response& res, std::string_view message);
 void api_success(const httplib::Request& req, httplib::Response& res, std::string_view message);
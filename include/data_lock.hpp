@@ -0,0 +1,21 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+#include <mutex>
+#include <shared_mutex>
+
+namespace budget {
+
+// The data of budgetwarrior (expenses, earnings, assets, ...) is global and not
+// synchronized. Every handler reading it must hold a read lock, and every action
+// modifying it must hold the write lock.
+std::shared_lock<std::shared_mutex> read_data();
+std::unique_lock<std::shared_mutex> write_data();
+
+} // end of namespace budget
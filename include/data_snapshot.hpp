@@ -0,0 +1,34 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include "data_cache.hpp"
+
+namespace budget {
+
+// An immutable view of the data at a given generation.
+//
+// All the lazy views of the cache (sorted_expenses(), user_assets(), the grouped
+// asset values and shares used by get_asset_value(), ...) are computed when the
+// snapshot is built. The accessors of data_cache are not const, but they then only
+// read the views, so the concurrent readers can share the snapshot.
+struct data_snapshot {
+    size_t                     generation = 0;
+    mutable budget::data_cache cache;
+};
+
+// The snapshot of the current data generation, built once by the first reader after
+// a change and published atomically. The caller must hold the read lock on the data
+// (see data_lock.hpp) while building it, but the snapshot itself can be used without
+// any lock.
+std::shared_ptr<const data_snapshot> get_data_snapshot();
+
+} // end of namespace budget
@@ -0,0 +1,21 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+namespace budget {
+
+// The rarely used data (fortunes, wishes, debts and objectives) is not loaded at
+// startup but on first use, once. Every page and API function using one of these
+// collections must first call the matching require function.
+
+void require_fortunes();
+void require_wishes();
+void require_debts();
+void require_objectives();
+
+} // end of namespace budget
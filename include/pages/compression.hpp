@@ -0,0 +1,63 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace httplib {
+struct Request;
+struct Response;
+}; // namespace httplib
+
+namespace budget {
+
+// A constant fragment compressed once, that can be spliced as is in any gzip response
+struct precompressed_fragment {
+    std::string   content;
+    std::string   deflated; // Raw deflate blocks, without reference to the surrounding data
+    std::uint32_t crc = 0;
+};
+
+precompressed_fragment precompress(std::string content);
+
+// Indicates if the client accepts gzip and the content is large enough to be worth compressing
+bool accepts_gzip(const httplib::Request& req);
+bool should_compress(const httplib::Request& req, size_t size);
+
+// Indicates that the response depends on the Accept-Encoding of the request.
+// Must be set on every response for which compression was negotiated, even uncompressed.
+void vary_on_encoding(httplib::Response& res);
+
+// Compress the content with gzip. The fragments that appear, in order, in the
+// content are not compressed again.
+std::string gzip_compress(std::string_view content, std::span<const precompressed_fragment* const> fragments = {});
+
+// Compress the body of the response in place, if worth it
+void compress_response(const httplib::Request& req, httplib::Response& res);
+
+// Incremental gzip compression, for the streamed responses
+struct gzip_stream {
+    gzip_stream();
+    ~gzip_stream();
+
+    gzip_stream(const gzip_stream&)            = delete;
+    gzip_stream& operator=(const gzip_stream&) = delete;
+
+    // Append the compressed input to the output, the last call must finish the stream
+    void compress(std::string_view input, std::string& output, bool finish);
+
+private:
+    struct impl;
+    std::unique_ptr<impl> pimpl;
+};
+
+} // end of namespace budget
@@ -0,0 +1,32 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+namespace httplib {
+struct Server;
+}; // namespace httplib
+
+namespace budget {
+
+// The data endpoints serve the series of the time charts as JSON, so that the
+// pages stay small and the series are cached and validated independently.
+//
+// The content is {"series":[{"name":"...","epochs":[...],"values":[...]}, ...]}
+// with the epochs in milliseconds.
+//
+// With format=columnar, each serie is {"name","start","step","scale","deltas"}:
+// the values are integers divided by scale, encoded as deltas from the previous
+// value, at a fixed step from the start epoch.
+//
+// With points=N (or server_chart_points in the configuration), the series are
+// downsampled to about N points with Largest-Triangle-Three-Buckets. The first
+// day of each month and the current day keep their exact value. In the columnar
+// format, the offsets then give the number of steps between the values.
+void load_data_pages(httplib::Server& server);
+
+} // end of namespace budget
@@ -7,17 +7,20 @@
 
 #pragma once
 
+#include <memory>
 #include <regex>
 
+#include "data_snapshot.hpp"
 #include "date.hpp"
 #include "writer.hpp"
+#include "pages/output_buffer.hpp"
 
 namespace budget {
 
 struct html_writer : writer {
-    std::stringstream& os;
+    budget::output_buffer& os;
 
-    explicit html_writer(std::stringstream& os) : os(os){}
+    explicit html_writer(budget::output_buffer& os) : os(os){}
 
     ~html_writer() override = default;
 
@@ -58,15 +61,20 @@ struct html_writer : writer {
                        std::vector<std::string>         series_names,
                        std::vector<std::vector<float>>& series_values) override;
 
-    void defer_script(const std::string& script);
+    void defer_script(std::string script);
     void load_deferred_scripts();
 
     void use_module(const std::string& module);
 
+    // The shared views of the current data (see data_snapshot.hpp), to use instead of
+    // cache. Must only be used under the read lock of the data.
+    budget::data_cache& data();
+
 private:
-    std::vector<std::string> scripts;
-    std::vector<std::string> modules;
-    bool                     title_started = false;
+    std::shared_ptr<const data_snapshot> snapshot;
+    std::vector<std::string>             scripts;
+    std::vector<std::string>             modules;
+    bool                                 title_started = false;
 
     bool need_module(const std::string& module);
 };
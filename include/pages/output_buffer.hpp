@@ -0,0 +1,131 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+#include <atomic>
+#include <charconv>
+#include <concepts>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace budget {
+
+// Take a string from the pool of the current thread, with at least the given capacity
+std::string acquire_buffer(size_t capacity);
+
+// Give a string back to the pool of the current thread
+void release_buffer(std::string&& buffer);
+
+// Contiguous append-only output buffer, used instead of std::stringstream to
+// generate the pages. The storage is taken from a thread-local pool and can be
+// moved out without copy once complete.
+struct output_buffer {
+    explicit output_buffer(size_t capacity = 4096) : data(acquire_buffer(capacity)) {}
+
+    output_buffer(const output_buffer&)            = delete;
+    output_buffer& operator=(const output_buffer&) = delete;
+
+    output_buffer(output_buffer&& rhs) noexcept : data(std::move(rhs.data)) { rhs.data.clear(); }
+
+    output_buffer& operator=(output_buffer&& rhs) noexcept {
+        if (this != &rhs) {
+            release_buffer(std::move(data));
+            data = std::move(rhs.data);
+            rhs.data.clear();
+        }
+
+        return *this;
+    }
+
+    ~output_buffer() { release_buffer(std::move(data)); }
+
+    output_buffer& operator<<(std::string_view value) {
+        data.append(value);
+        return *this;
+    }
+
+    output_buffer& operator<<(const char* value) {
+        data.append(value);
+        return *this;
+    }
+
+    output_buffer& operator<<(const std::string& value) {
+        data.append(value);
+        return *this;
+    }
+
+    template <typename T>
+    output_buffer& operator<<(const T& value) {
+        if constexpr (std::same_as<T, char> || std::same_as<T, signed char> || std::same_as<T, unsigned char>) {
+            data.push_back(static_cast<char>(value));
+        } else if constexpr (std::same_as<T, bool>) {
+            data.push_back(value ? '1' : '0');
+        } else if constexpr (std::integral<T>) {
+            append_chars([&value](char* first, char* last) { return std::to_chars(first, last, value); });
+        } else if constexpr (std::floating_point<T>) {
+            // Same output as the default formatting of the streams
+            append_chars([&value](char* first, char* last) { return std::to_chars(first, last, value, std::chars_format::general, 6); });
+        } else {
+            append_streamed(value);
+        }
+
+        return *this;
+    }
+
+    void reserve(size_t capacity) { data.reserve(capacity); }
+
+    size_t size() const { return data.size(); }
+
+    std::string_view view() const { return data; }
+
+    // Move the content out of the buffer, without copy
+    std::string str() && { return std::move(data); }
+
+private:
+    std::string data;
+
+    template <typename F>
+    void append_chars(F convert) {
+        char chars[64];
+        auto [end, ec] = convert(chars, chars + sizeof(chars));
+        data.append(chars, end);
+    }
+
+    // The types with their own stream operator (dates, money, ...) go through a
+    // stream reused by the current thread
+    template <typename T>
+    void append_streamed(const T& value) {
+        thread_local std::ostringstream stream = [] {
+            std::ostringstream s;
+            s.imbue(std::locale("C"));
+            return s;
+        }();
+
+        stream.str({});
+        stream << value;
+        data.append(stream.view());
+    }
+};
+
+// Running estimate of the size of the output of a route, used to size its buffer up front
+struct size_estimate {
+    size_t get() const { return estimate.load(std::memory_order_relaxed); }
+
+    void update(size_t size) {
+        // Exponential moving average, reacting quickly to growth
+        const auto current = get();
+        estimate.store(size > current ? size : (3 * current + size) / 4, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<size_t> estimate = 64 * 1024;
+};
+
+} // end of namespace budget
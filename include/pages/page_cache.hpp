@@ -0,0 +1,77 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace httplib {
+struct Request;
+struct Response;
+}; // namespace httplib
+
+namespace budget {
+
+// The data generation is incremented every time the data may have changed.
+// Anything derived from the data is valid as long as the generation is the same.
+size_t data_generation();
+void   bump_data_generation();
+
+// Strong validators for conditional requests
+std::string make_etag(std::string_view key, size_t generation);
+bool        etag_matches(const httplib::Request& req, std::string_view etag);
+
+struct page_cache_stats {
+    size_t hits    = 0;
+    size_t misses  = 0;
+    size_t entries = 0;
+    size_t bytes   = 0;
+};
+
+struct cached_page {
+    std::string content;
+    std::string encoding; // Empty if the content is not compressed
+};
+
+// In-memory LRU cache of the rendered pages, bounded in size
+bool                               is_page_cacheable(const httplib::Request& req);
+std::string                        page_cache_key(const httplib::Request& req);
+std::shared_ptr<const cached_page> page_cache_get(const std::string& key);
+void                               page_cache_put(const std::string& key, size_t generation, cached_page page);
+page_cache_stats                   get_page_cache_stats();
+
+// A response validated by its key and the data generation
+struct cached_response {
+    std::string key; // The compressed response is a different representation
+    std::string etag;
+    size_t      generation = 0; // Taken before computing the response, to detect changes in between
+};
+
+// Conditional responses, shared by the pages, the data and the API. The request
+// must be authenticated before anything is served.
+cached_response make_cached_response(const httplib::Request& req);
+void            set_validators(httplib::Response& res, const cached_response& cached);
+bool            serve_not_modified(const httplib::Request& req, httplib::Response& res, const cached_response& cached);
+bool            serve_cached(const httplib::Request& req, httplib::Response& res, const cached_response& cached, const char* content_type);
+void            cache_response(const httplib::Response& res, const cached_response& cached);
+
+// The valid pages of the cache, from the most recently used
+std::vector<std::pair<std::string, std::shared_ptr<const cached_page>>> page_cache_entries();
+
+// Save the valid pages to a snapshot in the budget folder, and restore them at
+// startup if neither the data files, the configuration nor the server changed
+// in between (by size and modification time). Only the rendered pages are
+// restored, the data files are still parsed at startup and the views of the
+// data are still computed on first use. Disabled with server_page_cache_snapshot=false.
+void save_page_cache();
+void load_page_cache();
+
+} // end of namespace budget
@@ -12,6 +12,7 @@
 
 #include "date.hpp"
 #include "money.hpp"
+#include "pages/output_buffer.hpp"
 
 namespace httplib {
 struct Server;
@@ -26,8 +27,11 @@ struct html_writer;
 
 void load_pages(httplib::Server& server);
 
+// Rebuild the static fragments of the pages, must be called when the configuration changes
+void rebuild_page_fragments();
+
 bool authenticate(const httplib::Request& req, httplib::Response& res);
-bool page_start(const httplib::Request& req, httplib::Response& res, std::stringstream& content_stream, std::string_view title);
+bool page_start(const httplib::Request& req, httplib::Response& res, budget::output_buffer& content_stream, std::string_view title);
 void page_end(budget::html_writer& w, const httplib::Request& req, httplib::Response& res);
 bool validate_parameters(html_writer& w, const httplib::Request& req, const std::vector<const char*> & parameters);
 
@@ -59,15 +63,15 @@ void add_file_picker(budget::writer& w);
 void add_paid_picker(budget::writer& w, bool paid);
 void add_date_picker(budget::writer& w, std::string_view default_value = "", bool one_line = false);
 
-void add_raw_account_picker(budget::writer& w, budget::date day, std::string_view default_value = "", std::string_view name = "input_account");
-void add_account_picker(budget::writer& w, budget::date day, std::string_view default_value = "");
+void add_raw_account_picker(budget::html_writer& w, budget::date day, std::string_view default_value = "", std::string_view name = "input_account");
+void add_account_picker(budget::html_writer& w, budget::date day, std::string_view default_value = "");
 
 void add_account_picker_by_name(
         budget::writer& w, budget::date day, std::string_view title, std::string_view default_value, std::string_view input, bool allow_empty = false);
-void add_share_asset_picker(budget::writer& w, std::string_view default_value = "");
-void add_value_asset_picker(budget::writer& w, std::string_view default_value = "");
-void add_active_share_asset_picker(budget::writer& w, std::string_view default_value = "");
-void add_active_value_asset_picker(budget::writer& w, std::string_view default_value = "");
+void add_share_asset_picker(budget::html_writer& w, std::string_view default_value = "");
+void add_value_asset_picker(budget::html_writer& w, std::string_view default_value = "");
+void add_active_share_asset_picker(budget::html_writer& w, std::string_view default_value = "");
+void add_active_value_asset_picker(budget::html_writer& w, std::string_view default_value = "");
 void add_liability_picker(budget::writer& w, std::string_view default_value = "");
 void add_money_picker(budget::writer&  w,
                       std::string_view title,
@@ -79,15 +83,16 @@ void add_money_picker(budget::writer&  w,
 void add_integer_picker(budget::writer& w, std::string_view title, std::string_view name, bool negative, std::string_view default_value = "");
 
 // Charts
-std::stringstream start_chart_base(budget::html_writer& w, std::string_view chart_type, std::string_view id = "container", std::string_view style = "");
-std::stringstream start_chart(
+budget::output_buffer start_chart_base(budget::html_writer& w, std::string_view chart_type, std::string_view id = "container", std::string_view style = "");
+budget::output_buffer start_chart(
         budget::html_writer& w, std::string_view title, std::string_view chart_type, std::string_view id = "container", std::string_view style = "");
-std::stringstream start_time_chart(
+budget::output_buffer start_time_chart(
         budget::html_writer& w, std::string_view title, std::string_view chart_type, std::string_view id = "container", std::string_view style = "");
-void end_chart(budget::html_writer& w, std::stringstream& ss);
-void add_average_12_serie(std::stringstream& ss, const std::vector<budget::money>& serie, const std::vector<std::string>& dates);
-void add_average_24_serie(std::stringstream& ss, const std::vector<budget::money>& serie, const std::vector<std::string>& dates);
-void add_average_5_serie(std::stringstream& ss, std::vector<budget::money> serie, std::vector<std::string> dates);
+void end_chart(budget::html_writer& w, budget::output_buffer& ss);
+void end_data_chart(budget::html_writer& w, budget::output_buffer& ss, std::string_view id, std::string_view url);
+void add_average_12_serie(budget::output_buffer& ss, const std::vector<budget::money>& serie, const std::vector<std::string>& dates);
+void add_average_24_serie(budget::output_buffer& ss, const std::vector<budget::money>& serie, const std::vector<std::string>& dates);
+void add_average_5_serie(budget::output_buffer& ss, std::vector<budget::money> serie, std::vector<std::string> dates);
 
 unsigned short last_month(unsigned short year);
 
@@ -0,0 +1,158 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "assets.hpp"
+#include "liabilities.hpp"
+#include "date.hpp"
+#include "money.hpp"
+
+namespace budget {
+
+struct data_cache;
+
+// A serie of values with one value per day, starting at first
+struct daily_serie {
+    budget::date               first;
+    std::vector<budget::money> values;
+
+    size_t size() const {
+        return values.size();
+    }
+
+    bool empty() const {
+        return values.empty();
+    }
+
+    // The value at the given day (zero before the serie, last value after the serie)
+    budget::money at(budget::date d) const;
+};
+
+// Number of days between two dates (negative if b is before a)
+int64_t days_between(budget::date a, budget::date b);
+
+// Milliseconds since the Unix epoch at the start of the day, as used by the charts
+int64_t epoch_millis(budget::date d);
+
+// Walk day by day over the values of a set of assets and liabilities.
+//
+// The asset values and asset shares are sorted once and consumed as the
+// sweep advances, while a running state is kept for each asset. Walking n
+// days over m events costs O(n + m) instead of O(n * m) for get_asset_value
+struct asset_sweep {
+    asset_sweep(std::vector<budget::asset> assets, std::vector<budget::liability> liabilities, budget::date first, budget::date last);
+
+    bool valid() const;
+    void advance();
+
+    budget::date day() const {
+        return current;
+    }
+
+    size_t index() const {
+        return current_index;
+    }
+
+    const std::vector<budget::asset>& assets() const {
+        return sweep_assets;
+    }
+
+    const std::vector<budget::liability>& liabilities() const {
+        return sweep_liabilities;
+    }
+
+    // Value of the i-th asset at the current day, in the asset currency
+    budget::money asset_value(size_t i) const {
+        return asset_values[i];
+    }
+
+    // Value of the i-th asset at the current day, in the default currency
+    budget::money asset_value_conv(size_t i) const {
+        return asset_values_conv[i];
+    }
+
+    // Value of the i-th liability at the current day, in the default currency
+    budget::money liability_value_conv(size_t i) const {
+        return liability_values_conv[i];
+    }
+
+private:
+    struct event {
+        budget::date  date;
+        size_t        target;
+        bool          liability;
+        bool          share;
+        int64_t       shares;
+        budget::money amount;
+    };
+
+    std::vector<budget::asset>     sweep_assets;
+    std::vector<budget::liability> sweep_liabilities;
+
+    budget::date current;
+    budget::date last;
+    size_t       current_index = 0;
+
+    std::vector<event> events;
+    size_t             next_event = 0;
+
+    std::vector<std::string> currencies;
+    std::vector<size_t>      asset_currency;
+    std::vector<size_t>      liability_currency;
+
+    std::vector<int64_t>       shares;
+    std::vector<budget::money> raw_asset_values;
+    std::vector<budget::money> raw_liability_values;
+
+    std::vector<budget::money> asset_values;
+    std::vector<budget::money> asset_values_conv;
+    std::vector<budget::money> liability_values_conv;
+
+    void update();
+};
+
+// Dense matrix of the allocation fraction of each asset (rows) in each asset class (columns)
+struct allocation_matrix {
+    size_t             rows    = 0;
+    size_t             columns = 0;
+    std::vector<float> fractions;
+
+    float operator()(size_t row, size_t column) const {
+        return fractions[row * columns + column];
+    }
+};
+
+allocation_matrix make_allocation_matrix(const std::vector<budget::asset>& assets, const std::vector<budget::asset_class>& classes);
+allocation_matrix make_allocation_matrix(const std::vector<budget::liability>& liabilities, const std::vector<budget::asset_class>& classes);
+
+// Daily series from the first asset date to today
+daily_serie asset_value_serie(data_cache& cache, const budget::asset& asset);
+daily_serie asset_value_conv_serie(data_cache& cache, const budget::asset& asset);
+daily_serie net_worth_serie(data_cache& cache);
+daily_serie fi_net_worth_serie(data_cache& cache);
+daily_serie portfolio_serie(data_cache& cache);
+
+// Daily series of the value of each asset class, in the order of cache.asset_classes().
+// With portfolio set, only the portfolio assets are considered and liabilities are ignored.
+std::vector<daily_serie> asset_class_series(data_cache& cache, bool portfolio);
+
+// Daily series of the value held in each currency, converted to the default currency.
+// With portfolio set, only the portfolio assets are considered and liabilities are ignored.
+std::map<std::string, daily_serie, std::less<>> currency_series(data_cache& cache, bool portfolio);
+
+// Select the indices of the values to keep to draw them with at most target points
+// (but at least the first and last), with the Largest-Triangle-Three-Buckets
+// algorithm. The first and last values and the kept indices (sorted) are selected
+// first, evenly thinned if they exceed the target, the rest is spread between them.
+std::vector<size_t> downsample(const std::vector<double>& values, size_t target, const std::vector<size_t>& kept);
+
+} // end of namespace budget
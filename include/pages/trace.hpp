@@ -0,0 +1,77 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+// Tracing of the renders, only compiled with BUDGET_TRACE (make TRACE=1).
+//
+// BUDGET_TRACE_SPAN("name") records the time until the end of the scope, nested
+// in the enclosing spans. The spans are only recorded for the pages requested
+// with the trace parameter: trace=json returns the Chrome trace events (to open
+// in chrome://tracing or Perfetto) instead of the page, any other value appends
+// the timings to the page.
+
+#ifdef BUDGET_TRACE
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace httplib {
+struct Request;
+struct Response;
+}; // namespace httplib
+
+namespace budget {
+
+struct trace_event {
+    const char* name;
+    int64_t     start;    // In microseconds, from the start of the trace
+    int64_t     duration; // In microseconds
+    size_t      depth;
+};
+
+// Record the spans of the current thread while alive, if enabled
+struct trace_recorder {
+    explicit trace_recorder(bool enabled);
+    ~trace_recorder();
+
+    trace_recorder(const trace_recorder&)            = delete;
+    trace_recorder& operator=(const trace_recorder&) = delete;
+
+    // Add the trace to the response, must be called before compressing it
+    void write(const httplib::Request& req, httplib::Response& res);
+
+    std::chrono::steady_clock::time_point start;
+    std::vector<trace_event>              events;
+    size_t                                depth   = 0;
+    bool                                  enabled = false;
+};
+
+struct trace_span {
+    explicit trace_span(const char* name);
+    ~trace_span();
+
+    trace_span(const trace_span&)            = delete;
+    trace_span& operator=(const trace_span&) = delete;
+
+private:
+    trace_recorder* recorder;
+    size_t          index = 0;
+};
+
+} // end of namespace budget
+
+#define BUDGET_TRACE_CONCAT_IMPL(a, b) a##b
+#define BUDGET_TRACE_CONCAT(a, b) BUDGET_TRACE_CONCAT_IMPL(a, b)
+#define BUDGET_TRACE_SPAN(name) budget::trace_span BUDGET_TRACE_CONCAT(trace_span_, __LINE__)(name)
+
+#else
+
+#define BUDGET_TRACE_SPAN(name)
+
+#endif
@@ -0,0 +1,29 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+#include <string>
+
+namespace httplib {
+struct Server;
+}; // namespace httplib
+
+namespace budget {
+
+// Measure the latency and the size of every response of the server, per route.
+// The numbers in the path are replaced by :id so that /asset/12/ and /asset/13/
+// are the same route.
+//
+// The requests slower than server_slow_request (in milliseconds, default 1000,
+// 0 to disable) are logged.
+void install_request_metrics(httplib::Server& server);
+
+// All the metrics of the server, in the Prometheus text format
+std::string prometheus_metrics();
+
+} // end of namespace budget
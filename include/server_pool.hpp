@@ -0,0 +1,45 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+#include <cstddef>
+
+namespace httplib {
+class Server;
+}; // namespace httplib
+
+namespace budget {
+
+// A task of the pool is a connection, not a request: a worker serves all the
+// requests of a keep-alive connection until it is closed. The requests are
+// counted by the request metrics.
+struct server_pool_stats {
+    size_t threads     = 0; // Number of workers
+    size_t capacity    = 0; // Maximum number of queued connections, 0 if unbounded
+    size_t queued      = 0; // Connections waiting for a worker
+    size_t active      = 0; // Connections held by a worker, including idle keep-alive ones
+    size_t connections = 0; // Connections served
+    size_t rejected    = 0; // Connections refused because the queue was full
+
+    size_t wait_total_us = 0; // Time spent by the served connections in the queue
+    size_t wait_max_us   = 0;
+};
+
+// Run the connections of the server on a pool of workers.
+//
+// The configuration is:
+//  * server_threads: the number of workers (default: the number of cores, at least 8)
+//  * server_queue_depth: the maximum number of waiting connections (default: 0, unbounded)
+//  * server_queue_policy: "reject" closes the new connections when the queue is
+//    full, "block" makes the listener wait for a free slot (default: reject)
+//  * server_keep_alive_timeout: the seconds an idle connection holds its worker (default: httplib)
+//  * server_keep_alive_max_count: the requests served on a connection before closing it (default: httplib)
+void              configure_server_pool(httplib::Server& server);
+server_pool_stats get_server_pool_stats();
+
+} // end of namespace budget
@@ -5,6 +5,7 @@
 //  http://opensource.org/licenses/MIT)
 //=======================================================================
 
+#include "api/list_api.hpp"
 #include "api/server_api.hpp"
 #include "api/accounts_api.hpp"
 
@@ -71,15 +72,7 @@ void budget::delete_accounts_api(const httplib::Request& req, httplib::Response&
 }
 
 void budget::list_accounts_api(const httplib::Request& req, httplib::Response& res) {
-    std::stringstream ss;
-
-    for (auto& account : all_accounts()) {
-        data_writer writer;
-        account.save(writer);
-        ss << writer.to_string() << std::endl;
-    }
-
-    api_success_content(req, res, ss.str());
+    api_list(req, res, "accounts", all_accounts());
 }
 
 void budget::archive_accounts_month_api(const httplib::Request& req, httplib::Response& res) {
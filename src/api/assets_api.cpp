@@ -7,6 +7,7 @@
 
 #include <set>
 
+#include "api/list_api.hpp"
 #include "api/server_api.hpp"
 #include "api/assets_api.hpp"
 
@@ -123,15 +124,7 @@ void budget::delete_assets_api(const httplib::Request& req, httplib::Response& r
 }
 
 void budget::list_assets_api(const httplib::Request& req, httplib::Response& res) {
-    std::stringstream ss;
-
-    for (auto& asset : all_assets()) {
-        data_writer writer;
-        asset.save(writer);
-        ss << writer.to_string() << std::endl;
-    }
-
-    api_success_content(req, res, ss.str());
+    api_list(req, res, "assets", all_assets());
 }
 
 void budget::add_asset_values_api(const httplib::Request& req, httplib::Response& res) {
@@ -190,15 +183,7 @@ void budget::delete_asset_values_api(const httplib::Request& req, httplib::Respo
 }
 
 void budget::list_asset_values_api(const httplib::Request& req, httplib::Response& res) {
-    std::stringstream ss;
-
-    for (auto& asset_value : all_asset_values()) {
-        data_writer writer;
-        asset_value.save(writer);
-        ss << writer.to_string() << std::endl;
-    }
-
-    api_success_content(req, res, ss.str());
+    api_list(req, res, "asset_values", all_asset_values());
 }
 
 void budget::batch_asset_values_api(const httplib::Request& req, httplib::Response& res) {
@@ -289,15 +274,7 @@ void budget::delete_asset_shares_api(const httplib::Request& req, httplib::Respo
 }
 
 void budget::list_asset_shares_api(const httplib::Request& req, httplib::Response& res) {
-    std::stringstream ss;
-
-    for (auto& asset_share : all_asset_shares()) {
-        data_writer writer;
-        asset_share.save(writer);
-        ss << writer.to_string() << std::endl;
-    }
-
-    api_success_content(req, res, ss.str());
+    api_list(req, res, "asset_shares", all_asset_shares());
 }
 
 // Asset Classes
@@ -362,15 +339,7 @@ void budget::delete_asset_classes_api(const httplib::Request& req, httplib::Resp
 }
 
 void budget::list_asset_classes_api(const httplib::Request& req, httplib::Response& res) {
-    std::stringstream ss;
-
-    for (const auto& asset_class : all_asset_classes()) {
-        data_writer writer;
-        asset_class.save(writer);
-        ss << writer.to_string() << std::endl;
-    }
-
-    api_success_content(req, res, ss.str());
+    api_list(req, res, "asset_classes", all_asset_classes());
 }
 
 // Liabilities
@@ -444,13 +413,5 @@ void budget::delete_liabilities_api(const httplib::Request& req, httplib::Respon
 }
 
 void budget::list_liabilities_api(const httplib::Request& req, httplib::Response& res) {
-    std::stringstream ss;
-
-    for (auto& liability : all_liabilities()) {
-        data_writer writer;
-        liability.save(writer);
-        ss << writer.to_string() << std::endl;
-    }
-
-    api_success_content(req, res, ss.str());
+    api_list(req, res, "liabilities", all_liabilities());
 }
@@ -7,6 +7,7 @@
 
 #include <set>
 
+#include "api/list_api.hpp"
 #include "api/server_api.hpp"
 #include "api/debts_api.hpp"
 
@@ -15,10 +16,13 @@
 #include "guid.hpp"
 #include "http.hpp"
 #include "data.hpp"
+#include "lazy_data.hpp"
 
 using namespace budget;
 
 void budget::add_debts_api(const httplib::Request& req, httplib::Response& res) {
+    require_debts();
+
     if (!req.has_param("input_name") || !req.has_param("input_amount") || !req.has_param("input_title") || !req.has_param("input_direction")) {
         return api_error(req, res, "Invalid parameters");
     }
@@ -38,6 +42,8 @@ void budget::add_debts_api(const httplib::Request& req, httplib::Response& res)
 }
 
 void budget::edit_debts_api(const httplib::Request& req, httplib::Response& res) {
+    require_debts();
+
     if (!req.has_param("input_id") || !req.has_param("input_name") || !req.has_param("input_amount") || !req.has_param("input_title")
         || !req.has_param("input_direction") || !req.has_param("input_paid")) {
         return api_error(req, res, "Invalid parameters");
@@ -62,6 +68,8 @@ void budget::edit_debts_api(const httplib::Request& req, httplib::Response& res)
 }
 
 void budget::delete_debts_api(const httplib::Request& req, httplib::Response& res) {
+    require_debts();
+
     if (!req.has_param("input_id")) {
         return api_error(req, res, "Invalid parameters");
     }
@@ -78,13 +86,7 @@ void budget::delete_debts_api(const httplib::Request& req, httplib::Response& re
 }
 
 void budget::list_debts_api(const httplib::Request& req, httplib::Response& res) {
-    std::stringstream ss;
-
-    for (auto& debt : all_debts()) {
-        data_writer writer;
-        debt.save(writer);
-        ss << writer.to_string() << std::endl;
-    }
+    require_debts();
 
-    api_success_content(req, res, ss.str());
+    api_list(req, res, "debts", all_debts());
 }
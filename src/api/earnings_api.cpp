@@ -7,6 +7,7 @@
 
 #include <set>
 
+#include "api/list_api.hpp"
 #include "api/server_api.hpp"
 #include "api/earnings_api.hpp"
 
@@ -73,13 +74,5 @@ void budget::delete_earnings_api(const httplib::Request& req, httplib::Response&
 }
 
 void budget::list_earnings_api(const httplib::Request& req, httplib::Response& res) {
-    std::stringstream ss;
-
-    for (auto& earning : all_earnings()) {
-        data_writer writer;
-        earning.save(writer);
-        ss << writer.to_string() << std::endl;
-    }
-
-    api_success_content(req, res, ss.str());
+    api_list(req, res, "earnings", all_earnings());
 }
@@ -9,6 +9,7 @@
 #include <set>
 
 #include "accounts.hpp"
+#include "api/list_api.hpp"
 #include "api/server_api.hpp"
 #include "api/expenses_api.hpp"
 
@@ -77,15 +78,7 @@ void budget::delete_expenses_api(const httplib::Request& req, httplib::Response&
 }
 
 void budget::list_expenses_api(const httplib::Request& req, httplib::Response& res) {
-    std::stringstream ss;
-
-    for (auto& expense : all_expenses() | persistent) {
-        data_writer writer;
-        expense.save(writer);
-        ss << writer.to_string() << std::endl;
-    }
-
-    api_success_content(req, res, ss.str());
+    api_list(req, res, "expenses", all_expenses() | persistent);
 }
 
 void budget::import_expenses_api(const httplib::Request& req, httplib::Response& res) {
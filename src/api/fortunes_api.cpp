@@ -7,6 +7,7 @@
 
 #include <set>
 
+#include "api/list_api.hpp"
 #include "api/server_api.hpp"
 #include "api/fortunes_api.hpp"
 
@@ -15,10 +16,13 @@
 #include "guid.hpp"
 #include "http.hpp"
 #include "data.hpp"
+#include "lazy_data.hpp"
 
 using namespace budget;
 
 void budget::add_fortunes_api(const httplib::Request& req, httplib::Response& res) {
+    require_fortunes();
+
     if (!req.has_param("input_amount") || !req.has_param("input_date")) {
         return api_error(req, res, "Invalid parameters");
     }
@@ -33,6 +37,8 @@ void budget::add_fortunes_api(const httplib::Request& req, httplib::Response& re
 }
 
 void budget::edit_fortunes_api(const httplib::Request& req, httplib::Response& res) {
+    require_fortunes();
+
     if (!req.has_param("input_id") || !req.has_param("input_amount") || !req.has_param("input_date")) {
         return api_error(req, res, "Invalid parameters");
     }
@@ -53,6 +59,8 @@ void budget::edit_fortunes_api(const httplib::Request& req, httplib::Response& r
 }
 
 void budget::delete_fortunes_api(const httplib::Request& req, httplib::Response& res) {
+    require_fortunes();
+
     if (!req.has_param("input_id")) {
         return api_error(req, res, "Invalid parameters");
     }
@@ -69,13 +77,7 @@ void budget::delete_fortunes_api(const httplib::Request& req, httplib::Response&
 }
 
 void budget::list_fortunes_api(const httplib::Request& req, httplib::Response& res) {
-    std::stringstream ss;
-
-    for (auto& fortune : all_fortunes()) {
-        data_writer writer;
-        fortune.save(writer);
-        ss << writer.to_string() << std::endl;
-    }
+    require_fortunes();
 
-    api_success_content(req, res, ss.str());
+    api_list(req, res, "fortunes", all_fortunes());
 }
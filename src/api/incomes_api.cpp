@@ -7,6 +7,7 @@
 
 #include <set>
 
+#include "api/list_api.hpp"
 #include "api/server_api.hpp"
 #include "api/incomes_api.hpp"
 
@@ -65,13 +66,5 @@ void budget::delete_incomes_api(const httplib::Request& req, httplib::Response&
 }
 
 void budget::list_incomes_api(const httplib::Request& req, httplib::Response& res) {
-    std::stringstream ss;
-
-    for (auto& income : all_incomes()) {
-        data_writer writer;
-        income.save(writer);
-        ss << writer.to_string() << std::endl;
-    }
-
-    api_success_content(req, res, ss.str());
+    api_list(req, res, "incomes", all_incomes());
 }
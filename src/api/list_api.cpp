@@ -0,0 +1,241 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <algorithm>
+#include <format>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "api/list_api.hpp"
+#include "api/server_api.hpp"
+
+#include "pages/compression.hpp"
+#include "pages/page_cache.hpp"
+#include "http.hpp"
+
+using namespace budget;
+
+namespace {
+
+struct journal_entry {
+    size_t hash;
+    size_t size;       // The size of the serialized record
+    size_t generation; // The generation at which the record was last seen modified
+};
+
+// The journal remembers the state of a collection as it was last sent. The
+// records are compared to the journal on each list, so that all changes are
+// detected, whatever their origin (API, recurrings, ...).
+struct sync_journal {
+    size_t                                    updated = 0; // The generation of the last update
+    std::set<size_t>                          answered;    // The generations the journal was sent at
+    std::unordered_map<size_t, journal_entry> records;
+    std::unordered_map<size_t, size_t>        deleted; // id -> generation of the deletion
+};
+
+// The size above which a chunk of the list is sent
+constexpr size_t list_chunk_size = 64 * 1024;
+
+// The maximum number of deletions and answered generations remembered per collection
+constexpr size_t max_deleted  = 4096;
+constexpr size_t max_answered = 4096;
+
+std::mutex                                    journals_lock;
+std::unordered_map<std::string, sync_journal> journals;
+
+// Note: journals_lock must be held
+bool is_up_to_date(const sync_journal& journal, size_t generation, const std::vector<size_t>& ids) {
+    return journal.updated == generation && journal.records.size() == ids.size();
+}
+
+// Forget the oldest deletions and generations, the clients older than them get a full list
+// Note: journals_lock must be held
+void trim_journal(sync_journal& journal) {
+    if (journal.deleted.size() > max_deleted) {
+        std::vector<std::pair<size_t, size_t>> deletions(journal.deleted.begin(), journal.deleted.end());
+
+        auto oldest = deletions.begin() + (deletions.size() - max_deleted);
+        std::ranges::nth_element(deletions, oldest, {}, &std::pair<size_t, size_t>::second);
+
+        size_t horizon = 0;
+
+        for (auto it = deletions.begin(); it != oldest; ++it) {
+            journal.deleted.erase(it->first);
+            horizon = std::max(horizon, it->second);
+        }
+
+        journal.answered.erase(journal.answered.begin(), journal.answered.lower_bound(horizon));
+    }
+
+    while (journal.answered.size() > max_answered) {
+        journal.answered.erase(journal.answered.begin());
+    }
+}
+
+} // end of anonymous namespace
+
+void budget::api_list_content(const httplib::Request& req,
+                              httplib::Response&      res,
+                              std::string_view        collection,
+                              std::vector<size_t>     ids,
+                              list_hasher             hasher,
+                              list_serializer         serializer) {
+    // The caller holds the read lock of the data, the generation cannot change during the list
+    const auto generation = data_generation();
+
+    bool up_to_date = false;
+
+    {
+        const std::lock_guard guard(journals_lock);
+
+        if (auto it = journals.find(std::string(collection)); it != journals.end()) {
+            up_to_date = is_up_to_date(it->second, generation, ids);
+        }
+    }
+
+    // The records are only serialized to be hashed if the data changed since the last
+    // list, and outside of the lock. Otherwise, the hashes of the journal are still valid.
+    std::vector<record_digest> digests;
+
+    if (!up_to_date) {
+        digests.reserve(ids.size());
+
+        for (size_t i = 0; i < ids.size(); ++i) {
+            digests.push_back(hasher(i));
+        }
+    }
+
+    std::vector<size_t> changed; // Indices of the records changed since the client generation
+    size_t              size = 0; // The expected size of the content
+    std::vector<size_t> deleted; // Ids of the records deleted since the client generation
+
+    bool delta = false;
+
+    {
+        const std::lock_guard guard(journals_lock);
+
+        auto& journal = journals[std::string(collection)];
+
+        // A delta can only be computed from a generation this journal was sent at
+        size_t since = 0;
+        if (req.has_param("since")) {
+            since = to_number<size_t>(req.get_param_value("since"));
+            delta = journal.answered.contains(since);
+        }
+
+        // Update the journal with the current state of the collection
+
+        if (!digests.empty() || !is_up_to_date(journal, generation, ids)) {
+            std::unordered_map<size_t, journal_entry> current;
+            current.reserve(ids.size());
+
+            for (size_t i = 0; i < ids.size(); ++i) {
+                const auto digest = i < digests.size() ? digests[i] : hasher(i);
+
+                auto previous = journal.records.find(ids[i]);
+
+                if (previous == journal.records.end() || previous->second.hash != digest.hash) {
+                    current[ids[i]] = {digest.hash, digest.size, generation};
+                    journal.deleted.erase(ids[i]);
+                } else {
+                    current[ids[i]] = previous->second;
+                }
+            }
+
+            for (const auto& [id, entry] : journal.records) {
+                if (!current.contains(id)) {
+                    journal.deleted[id] = generation;
+                }
+            }
+
+            journal.records = std::move(current);
+            journal.updated = generation;
+        }
+
+        for (size_t i = 0; i < ids.size(); ++i) {
+            if (const auto& entry = journal.records.at(ids[i]); !delta || entry.generation > since) {
+                changed.push_back(i);
+                size += entry.size;
+            }
+        }
+
+        if (delta) {
+            for (const auto& [id, deleted_generation] : journal.deleted) {
+                if (deleted_generation > since) {
+                    deleted.push_back(id);
+                    size += 32;
+                }
+            }
+        }
+
+        journal.answered.insert(generation);
+
+        trim_journal(journal);
+    }
+
+    res.set_header("X-Budget-Generation", std::to_string(generation));
+    res.set_header("X-Budget-Sync", delta ? "delta" : "full");
+    vary_on_encoding(res);
+
+    struct stream_state {
+        std::vector<size_t>          changed;
+        std::vector<size_t>          deleted;
+        list_serializer              serializer;
+        std::unique_ptr<gzip_stream> gzip;
+        size_t                       next = 0;
+        std::string                  buffer;
+        std::string                  compressed;
+    };
+
+    auto state = std::make_shared<stream_state>(std::move(changed), std::move(deleted), std::move(serializer));
+
+    if (should_compress(req, size)) {
+        state->gzip = std::make_unique<gzip_stream>();
+        res.set_header("Content-Encoding", "gzip");
+    }
+
+    res.set_chunked_content_provider("text/plain", [state](size_t /*offset*/, httplib::DataSink& sink) {
+        auto& buffer = state->buffer;
+        buffer.clear();
+
+        const size_t total = state->changed.size() + state->deleted.size();
+
+        // Fill one chunk at a time, the records are serialized on the fly
+        while (state->next < total && buffer.size() < list_chunk_size) {
+            if (state->next < state->changed.size()) {
+                state->serializer(state->changed[state->next], buffer);
+            } else {
+                buffer += std::format("deleted:{}\n", state->deleted[state->next - state->changed.size()]);
+            }
+
+            ++state->next;
+        }
+
+        const bool finished = state->next == total;
+
+        std::string_view chunk = buffer;
+
+        if (state->gzip) {
+            state->compressed.clear();
+            state->gzip->compress(buffer, state->compressed, finished);
+            chunk = state->compressed;
+        }
+
+        if (!chunk.empty() && !sink.write(chunk.data(), chunk.size())) {
+            return false;
+        }
+
+        if (finished) {
+            sink.done();
+        }
+
+        return true;
+    });
+}
@@ -7,6 +7,7 @@
 
 #include <set>
 
+#include "api/list_api.hpp"
 #include "api/server_api.hpp"
 #include "api/objectives_api.hpp"
 
@@ -14,10 +15,13 @@
 #include "guid.hpp"
 #include "http.hpp"
 #include "data.hpp"
+#include "lazy_data.hpp"
 
 using namespace budget;
 
 void budget::add_objectives_api(const httplib::Request& req, httplib::Response& res) {
+    require_objectives();
+
     if (!parameters_present(req, {"input_name", "input_type", "input_type", "input_source", "input_operator", "input_amount"})) {
         return api_error(req, res, "Invalid parameters");
     }
@@ -36,6 +40,8 @@ void budget::add_objectives_api(const httplib::Request& req, httplib::Response&
 }
 
 void budget::edit_objectives_api(const httplib::Request& req, httplib::Response& res) {
+    require_objectives();
+
     if (!parameters_present(req, {"input_id", "input_name", "input_type", "input_type", "input_source", "input_operator", "input_amount"})) {
         return api_error(req, res, "Invalid parameters");
     }
@@ -59,6 +65,8 @@ void budget::edit_objectives_api(const httplib::Request& req, httplib::Response&
 }
 
 void budget::delete_objectives_api(const httplib::Request& req, httplib::Response& res) {
+    require_objectives();
+
     if (!parameters_present(req, {"input_id"})) {
         return api_error(req, res, "Invalid parameters");
     }
@@ -75,13 +83,7 @@ void budget::delete_objectives_api(const httplib::Request& req, httplib::Respons
 }
 
 void budget::list_objectives_api(const httplib::Request& req, httplib::Response& res) {
-    std::stringstream ss;
-
-    for (auto& objective : all_objectives()) {
-        data_writer writer;
-        objective.save(writer);
-        ss << writer.to_string() << std::endl;
-    }
+    require_objectives();
 
-    api_success_content(req, res, ss.str());
+    api_list(req, res, "objectives", all_objectives());
 }
@@ -7,6 +7,7 @@
 
 #include <set>
 
+#include "api/list_api.hpp"
 #include "api/server_api.hpp"
 #include "api/recurrings_api.hpp"
 
@@ -92,13 +93,5 @@ void budget::delete_recurrings_api(const httplib::Request& req, httplib::Respons
 }
 
 void budget::list_recurrings_api(const httplib::Request& req, httplib::Response& res) {
-    std::stringstream ss;
-
-    for (auto& recurring : all_recurrings()) {
-        data_writer writer;
-        recurring.save(writer);
-        ss << writer.to_string() << std::endl;
-    }
-
-    api_success_content(req, res, ss.str());
+    api_list(req, res, "recurrings", all_recurrings());
 }
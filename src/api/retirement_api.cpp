@@ -12,7 +12,7 @@
 #include "liabilities.hpp"
 #include "accounts.hpp"
 #include "data.hpp"
-#include "data_cache.hpp"
+#include "data_snapshot.hpp"
 #include "retirement.hpp"
 
 #include "pages/web_config.hpp"
@@ -21,7 +21,8 @@ using namespace budget;
 
 void budget::retirement_countdown_api(const httplib::Request& req, httplib::Response& res) {
     if (auto fi_expenses = budget::get_fi_expenses()) {
-        data_cache cache;
+        const auto snapshot = get_data_snapshot();
+        auto&      cache    = snapshot->cache;
 
         const auto nw           = get_fi_net_worth(cache);
         const auto savings_rate = running_savings_rate(cache);
@@ -20,8 +20,14 @@
 #include "api/retirement_api.hpp"
 
 #include "pages/server_pages.hpp"
+#include "pages/compression.hpp"
+#include "pages/page_cache.hpp"
+
+#include "server_metrics.hpp"
+#include "server_pool.hpp"
 
 #include "config.hpp"
+#include "data_lock.hpp"
 #include "version.hpp"
 #include "writer.hpp"
 #include "http.hpp"
@@ -39,6 +45,26 @@ void server_version_api(const httplib::Request& req, httplib::Response& res) {
     api_success_content(req, res, get_version_short());
 }
 
+void server_pool_api(const httplib::Request& req, httplib::Response& res) {
+    auto stats = get_server_pool_stats();
+
+    std::string content;
+    content += std::format("threads={}\n", stats.threads);
+    content += std::format("capacity={}\n", stats.capacity);
+    content += std::format("queued={}\n", stats.queued);
+    content += std::format("active={}\n", stats.active);
+    content += std::format("connections={}\n", stats.connections);
+    content += std::format("rejected={}\n", stats.rejected);
+    content += std::format("wait_total_us={}\n", stats.wait_total_us);
+    content += std::format("wait_max_us={}\n", stats.wait_max_us);
+
+    api_success_content(req, res, content);
+}
+
+void server_metrics_api(const httplib::Request& /*req*/, httplib::Response& res) {
+    res.set_content(prometheus_metrics(), "text/plain; version=0.0.4");
+}
+
 void server_version_support_api(const httplib::Request& req, httplib::Response& res) {
     if (!parameters_present(req, {"version"})) {
         return api_error(req, res, "Invalid parameters");
@@ -67,16 +93,50 @@ void retirement_configure_api(const httplib::Request& req, httplib::Response& re
     api_success(req, res, "Retirement configuration was saved");
 }
 
+// Only the list API is read-only and can be answered conditionally
+bool is_conditional_api(const httplib::Request& req) {
+    return req.method == "GET" && req.path.ends_with("/list/");
+}
+
+// The actions modify the data, the other APIs only read it
+bool is_action(const httplib::Request& req) {
+    return req.method == "POST" || req.path.ends_with("/delete/");
+}
+
 auto api_wrapper(void (*api_function)(const httplib::Request&, httplib::Response&)) {
     return [api_function](const httplib::Request& req, httplib::Response& res) {
+        if (!api_start(req, res)) {
+            return;
+        }
+
+        // An action may fail after modifying the data, the lock covers its error handling
+        std::unique_lock<std::shared_mutex> action_lock;
+
+        if (is_action(req)) {
+            action_lock = write_data();
+        }
+
         try {
-            if (!api_start(req, res)) {
-                return;
+            LOG_F(INFO, "server: API access to {} by ", req.path, req.get_header_value("User-Agent"));
+
+            if (is_conditional_api(req)) {
+                const auto cached = make_cached_response(req);
+
+                if (serve_not_modified(req, res, cached)) {
+                    return;
+                }
+
+                set_validators(res, cached);
             }
 
-            LOG_F(INFO, "server: API access to {} by ", req.path, req.get_header_value("User-Agent"));
+                if (action_lock) {
+                api_function(req, res);
+            } else {
+                auto data_lock = read_data();
+                api_function(req, res);
+            }
 
-            api_function(req, res);
+            compress_response(req, res);
         } catch (const budget_exception& e) {
             api_error(req, res, std::format("Exception occurred: ", e.message()));
             LOG_F(ERROR, "budget_exception occured in render({}): {}", req.path, e.message());
@@ -143,6 +203,8 @@ void budget::load_api(httplib::Server& server) {
     server.Get("/api/server/up/", api_wrapper(&server_up_api));
     server.Get("/api/server/version/", api_wrapper(&server_version_api));
     server.Post("/api/server/version/support/", api_wrapper(&server_version_support_api));
+    server.Get("/api/server/pool/", api_wrapper(&server_pool_api));
+    server.Get("/api/server/metrics/", api_wrapper(&server_metrics_api));
 
     server.Post("/api/accounts/add/", api_wrapper(&add_accounts_api));
     server.Post("/api/accounts/edit/", api_wrapper(&edit_accounts_api));
@@ -233,6 +295,11 @@ bool budget::api_start(const httplib::Request& req, httplib::Response& res) {
 }
 
 void budget::api_error(const httplib::Request& req, httplib::Response& res, std::string_view message) {
+    // Some actions (imports for instance) may fail after modifying the data
+    if (is_action(req)) {
+        bump_data_generation();
+    }
+
     if (req.has_param("server")) {
         auto back_page = html_base64_decode(req.get_param_value("back_page"));
 
@@ -250,6 +317,8 @@ void budget::api_error(const httplib::Request& req, httplib::Response& res, std:
 }
 
 void budget::api_success(const httplib::Request& req, httplib::Response& res, std::string_view message) {
+    bump_data_generation();
+
     if (req.has_param("server")) {
         auto back_page = html_base64_decode(req.get_param_value("back_page"));
 
@@ -267,6 +336,8 @@ void budget::api_success(const httplib::Request& req, httplib::Response& res, st
 }
 
 void budget::api_success(const httplib::Request& req, httplib::Response& res, std::string_view message, const std::string& content) {
+    bump_data_generation();
+
     if (req.has_param("server")) {
         auto back_page = html_base64_decode(req.get_param_value("back_page"));
 
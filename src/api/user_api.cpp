@@ -9,6 +9,7 @@
 
 #include "api/server_api.hpp"
 #include "api/user_api.hpp"
+#include "pages/server_pages.hpp"
 
 #include "http.hpp"
 #include "config.hpp"
@@ -59,5 +60,8 @@ void budget::user_config_api(const httplib::Request& req, httplib::Response& res
 
     budget::save_config();
 
+    // The navigation depends on the configuration
+    rebuild_page_fragments();
+
     api_success(req, res, "Configuration has been updated");
 }
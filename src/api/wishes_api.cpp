@@ -7,6 +7,7 @@
 
 #include <set>
 
+#include "api/list_api.hpp"
 #include "api/server_api.hpp"
 #include "api/wishes_api.hpp"
 
@@ -15,10 +16,13 @@
 #include "guid.hpp"
 #include "http.hpp"
 #include "data.hpp"
+#include "lazy_data.hpp"
 
 using namespace budget;
 
 void budget::add_wishes_api(const httplib::Request& req, httplib::Response& res) {
+    require_wishes();
+
     if (!req.has_param("input_name") || !req.has_param("input_amount") || !req.has_param("input_urgency") || !req.has_param("input_importance")) {
         return api_error(req, res, "Invalid parameters");
     }
@@ -38,6 +42,8 @@ void budget::add_wishes_api(const httplib::Request& req, httplib::Response& res)
 }
 
 void budget::edit_wishes_api(const httplib::Request& req, httplib::Response& res) {
+    require_wishes();
+
     if (!req.has_param("input_id") || !req.has_param("input_name") || !req.has_param("input_amount") || !req.has_param("input_urgency")
         || !req.has_param("input_importance") || !req.has_param("input_paid") || !req.has_param("input_paid_amount")) {
         return api_error(req, res, "Invalid parameters");
@@ -68,6 +74,8 @@ void budget::edit_wishes_api(const httplib::Request& req, httplib::Response& res
 }
 
 void budget::delete_wishes_api(const httplib::Request& req, httplib::Response& res) {
+    require_wishes();
+
     if (!req.has_param("input_id")) {
         return api_error(req, res, "Invalid parameters");
     }
@@ -84,13 +92,7 @@ void budget::delete_wishes_api(const httplib::Request& req, httplib::Response& r
 }
 
 void budget::list_wishes_api(const httplib::Request& req, httplib::Response& res) {
-    std::stringstream ss;
-
-    for (auto& wish : all_wishes()) {
-        data_writer writer;
-        wish.save(writer);
-        ss << writer.to_string() << std::endl;
-    }
+    require_wishes();
 
-    api_success_content(req, res, ss.str());
+    api_list(req, res, "wishes", all_wishes());
 }
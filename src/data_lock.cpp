@@ -0,0 +1,24 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include "data_lock.hpp"
+
+using namespace budget;
+
+namespace {
+
+std::shared_mutex data_mutex;
+
+} // end of anonymous namespace
+
+std::shared_lock<std::shared_mutex> budget::read_data() {
+    return std::shared_lock{data_mutex};
+}
+
+std::unique_lock<std::shared_mutex> budget::write_data() {
+    return std::unique_lock{data_mutex};
+}
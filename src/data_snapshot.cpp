@@ -0,0 +1,90 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+#include "data_snapshot.hpp"
+#include "lazy_data.hpp"
+#include "logging.hpp"
+#include "pages/page_cache.hpp"
+
+using namespace budget;
+
+namespace {
+
+std::atomic<std::shared_ptr<const data_snapshot>> current_snapshot;
+
+// Only one thread builds a new snapshot, the others wait for it
+std::mutex build_lock;
+
+// Note: every lazy view of data_cache used by the server must be computed here
+void compute_views(budget::data_cache& cache) {
+    cache.accounts();
+    cache.expenses();
+    cache.sorted_expenses();
+    cache.earnings();
+    cache.sorted_earnings();
+    cache.objectives();
+    cache.assets();
+    cache.user_assets();
+    cache.active_user_assets();
+    cache.asset_classes();
+    cache.asset_values();
+    cache.sorted_asset_values();
+    cache.asset_shares();
+    cache.sorted_asset_shares();
+    cache.liabilities();
+
+    // The grouped values are looked up by id, every asset and liability gets its
+    // group here, so that the lookups never insert into the shared maps
+    auto& asset_values     = cache.sorted_group_asset_values(false);
+    auto& liability_values = cache.sorted_group_asset_values(true);
+    auto& asset_shares     = cache.sorted_group_asset_shares();
+
+    for (const auto& asset : cache.assets()) {
+        asset_values[asset.id];
+        asset_shares[asset.id];
+    }
+
+    for (const auto& liability : cache.liabilities()) {
+        liability_values[liability.id];
+    }
+}
+
+} // end of anonymous namespace
+
+std::shared_ptr<const data_snapshot> budget::get_data_snapshot() {
+    // Loading the objectives bumps the generation, it must be done before taking it
+    require_objectives();
+
+    const auto generation = data_generation();
+
+    if (auto snapshot = current_snapshot.load(); snapshot && snapshot->generation == generation) {
+        return snapshot;
+    }
+
+    std::lock_guard lock(build_lock);
+
+    if (auto snapshot = current_snapshot.load(); snapshot && snapshot->generation == generation) {
+        return snapshot;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    auto snapshot        = std::make_shared<data_snapshot>();
+    snapshot->generation = generation;
+    compute_views(snapshot->cache);
+
+    current_snapshot.store(snapshot);
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    LOG_F(INFO, "Built the data snapshot of generation {:x} in {}ms", generation, elapsed.count());
+
+    return snapshot;
+}
@@ -0,0 +1,67 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <chrono>
+#include <mutex>
+
+#include "lazy_data.hpp"
+
+#include "debts.hpp"
+#include "fortune.hpp"
+#include "logging.hpp"
+#include "objectives.hpp"
+#include "wishes.hpp"
+
+#include "pages/page_cache.hpp"
+
+using namespace budget;
+
+namespace {
+
+struct lazy_loader {
+    const char*    name;
+    void           (*load)();
+    std::once_flag loaded;
+};
+
+lazy_loader fortunes_loader{"fortunes", &load_fortunes, {}};
+lazy_loader wishes_loader{"wishes", &load_wishes, {}};
+lazy_loader debts_loader{"debts", &load_debts, {}};
+lazy_loader objectives_loader{"objectives", &load_objectives, {}};
+
+void require(lazy_loader& loader) {
+    std::call_once(loader.loaded, [&loader]() {
+        const auto start = std::chrono::steady_clock::now();
+
+        loader.load();
+
+        // The pages and snapshots built before the load did not see this data
+        bump_data_generation();
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        LOG_F(INFO, "Loaded the {} on first use in {}ms", loader.name, elapsed.count());
+    });
+}
+
+} // end of anonymous namespace
+
+void budget::require_fortunes() {
+    require(fortunes_loader);
+}
+
+void budget::require_wishes() {
+    require(wishes_loader);
+}
+
+void budget::require_debts() {
+    require(debts_loader);
+}
+
+void budget::require_objectives() {
+    require(objectives_loader);
+}
+
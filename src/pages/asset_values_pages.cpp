@@ -65,10 +65,10 @@ void budget::full_batch_asset_values_page(html_writer& w) {
 
     add_date_picker(w, budget::to_string(budget::local_day()), true);
 
-    auto assets = w.cache.user_assets();
+    auto assets = w.data().user_assets();
     std::ranges::sort(assets, [](const auto& lhs, const auto& rhs) { return lhs.name <= rhs.name; });
 
-    for (const auto& [asset, amount] : assets | not_share_based | expand_value(w.cache)) {
+    for (const auto& [asset, amount] : assets | not_share_based | expand_value(w.data())) {
         add_money_picker(w, asset.name, std::format("input_amount_{}", asset.id), budget::money_to_string(amount), true, true, asset.currency);
     }
 
@@ -82,10 +82,10 @@ void budget::current_batch_asset_values_page(html_writer& w) {
 
     add_date_picker(w, budget::to_string(budget::local_day()), true);
 
-    auto assets = w.cache.user_assets();
+    auto assets = w.data().user_assets();
     std::ranges::sort(assets, [](const auto& lhs, const auto& rhs) { return lhs.name <= rhs.name; });
 
-    for (const auto& [asset, amount] : assets | not_share_based | expand_value(w.cache) | not_zero) {
+    for (const auto& [asset, amount] : assets | not_share_based | expand_value(w.data()) | not_zero) {
         add_money_picker(w, asset.name, std::format("input_amount_{}", asset.id), budget::money_to_string(amount), true, true, asset.currency);
     }
 
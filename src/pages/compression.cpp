@@ -0,0 +1,206 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "pages/compression.hpp"
+#include "config.hpp"
+#include "http.hpp"
+#include "utils.hpp"
+
+using namespace budget;
+
+namespace {
+
+// gzip header without file name nor modification time
+constexpr std::string_view gzip_header{"\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\xff", 10};
+
+// A final deflate block without any data
+constexpr std::string_view deflate_end{"\x03\x00", 2};
+
+// The minimum size of a response to be compressed, 0 disables compression
+size_t compression_threshold() {
+    static const size_t threshold = to_number<size_t>(config_value("server_compression_threshold", "1024"));
+    return threshold;
+}
+
+bool is_compressible(std::string_view content_type) {
+    return content_type.starts_with("text/") || content_type.starts_with("application/json") || content_type.starts_with("application/javascript");
+}
+
+void append_le32(std::string& output, uint32_t value) {
+    for (size_t i = 0; i < 4; ++i) {
+        output.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+// Runs zlib until all the input is consumed and the flush is complete
+void run_deflate(z_stream& stream, std::string_view input, std::string& output, int flush) {
+    stream.next_in  = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = static_cast<uInt>(input.size());
+
+    do {
+        const size_t offset = output.size();
+        const size_t chunk  = std::max<size_t>(deflateBound(&stream, stream.avail_in), 64);
+
+        output.resize(offset + chunk);
+
+        stream.next_out  = reinterpret_cast<Bytef*>(output.data() + offset);
+        stream.avail_out = static_cast<uInt>(chunk);
+
+        deflate(&stream, flush);
+
+        output.resize(offset + chunk - stream.avail_out);
+    } while (stream.avail_out == 0 || stream.avail_in > 0);
+}
+
+// Compress the input as raw deflate blocks, ending on a byte boundary, without final block
+void deflate_piece(std::string_view input, std::string& output) {
+    if (input.empty()) {
+        return;
+    }
+
+    z_stream stream{};
+    deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+
+    run_deflate(stream, input, output, Z_SYNC_FLUSH);
+
+    deflateEnd(&stream);
+}
+
+uint32_t crc_of(std::string_view input) {
+    return crc32(crc32(0, nullptr, 0), reinterpret_cast<const Bytef*>(input.data()), static_cast<uInt>(input.size()));
+}
+
+} // end of anonymous namespace
+
+precompressed_fragment budget::precompress(std::string content) {
+    precompressed_fragment fragment;
+
+    deflate_piece(content, fragment.deflated);
+    fragment.crc     = crc_of(content);
+    fragment.content = std::move(content);
+
+    return fragment;
+}
+
+bool budget::accepts_gzip(const httplib::Request& req) {
+    if (!compression_threshold() || !req.has_header("Accept-Encoding")) {
+        return false;
+    }
+
+    for (auto coding : budget::splitv(req.get_header_value("Accept-Encoding"), ',')) {
+        std::string_view parameters;
+
+        if (auto semicolon = coding.find(';'); semicolon != std::string_view::npos) {
+            parameters = coding.substr(semicolon + 1);
+            coding     = coding.substr(0, semicolon);
+        }
+
+        while (!coding.empty() && coding.front() == ' ') {
+            coding.remove_prefix(1);
+        }
+
+        while (!coding.empty() && coding.back() == ' ') {
+            coding.remove_suffix(1);
+        }
+
+        if (coding == "gzip" || coding == "*") {
+            // A zero quality explicitly refuses the encoding
+            if (auto quality = parameters.find("q="); quality != std::string_view::npos) {
+                return std::strtod(std::string(parameters.substr(quality + 2)).c_str(), nullptr) > 0.0;
+            }
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool budget::should_compress(const httplib::Request& req, size_t size) {
+    return size >= compression_threshold() && accepts_gzip(req);
+}
+
+void budget::vary_on_encoding(httplib::Response& res) {
+    if (!res.has_header("Vary")) {
+        res.set_header("Vary", "Accept-Encoding");
+    }
+}
+
+std::string budget::gzip_compress(std::string_view content, std::span<const precompressed_fragment* const> fragments) {
+    std::string output;
+    output.reserve(content.size() / 4);
+    output += gzip_header;
+
+    uint32_t crc      = crc32(0, nullptr, 0);
+    size_t   position = 0;
+
+    auto add_piece = [&](std::string_view piece) {
+        deflate_piece(piece, output);
+        crc = crc32_combine(crc, crc_of(piece), static_cast<z_off_t>(piece.size()));
+    };
+
+    for (const auto* fragment : fragments) {
+        if (!content.substr(position).starts_with(fragment->content)) {
+            auto offset = content.find(fragment->content, position);
+
+            if (offset == std::string_view::npos) {
+                continue;
+            }
+
+            add_piece(content.substr(position, offset - position));
+            position = offset;
+        }
+
+        output += fragment->deflated;
+        crc = crc32_combine(crc, fragment->crc, static_cast<z_off_t>(fragment->content.size()));
+        position += fragment->content.size();
+    }
+
+    add_piece(content.substr(position));
+
+    output += deflate_end;
+
+    append_le32(output, crc);
+    append_le32(output, static_cast<uint32_t>(content.size()));
+
+    return output;
+}
+
+void budget::compress_response(const httplib::Request& req, httplib::Response& res) {
+    if (res.has_header("Content-Encoding") || !is_compressible(res.get_header_value("Content-Type"))) {
+        return;
+    }
+
+    vary_on_encoding(res);
+
+    if (should_compress(req, res.body.size())) {
+        res.body = gzip_compress(res.body);
+        res.set_header("Content-Encoding", "gzip");
+    }
+}
+
+struct budget::gzip_stream::impl {
+    z_stream stream{};
+};
+
+budget::gzip_stream::gzip_stream() : pimpl(std::make_unique<impl>()) {
+    // 16 is added to the window bits for the gzip header and trailer
+    deflateInit2(&pimpl->stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY);
+}
+
+budget::gzip_stream::~gzip_stream() {
+    deflateEnd(&pimpl->stream);
+}
+
+void budget::gzip_stream::compress(std::string_view input, std::string& output, bool finish) {
+    run_deflate(pimpl->stream, input, output, finish ? Z_FINISH : Z_SYNC_FLUSH);
+}
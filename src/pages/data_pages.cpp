@@ -0,0 +1,396 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <cmath>
+#include <format>
+
+#include "pages/data_pages.hpp"
+#include "pages/compression.hpp"
+#include "pages/output_buffer.hpp"
+#include "pages/page_cache.hpp"
+#include "pages/server_pages.hpp"
+#include "pages/time_series.hpp"
+#include "pages/web_config.hpp"
+
+#include "assets.hpp"
+#include "budget_exception.hpp"
+#include "config.hpp"
+#include "data_cache.hpp"
+#include "data_lock.hpp"
+#include "data_snapshot.hpp"
+#include "http.hpp"
+#include "logging.hpp"
+#include "retirement.hpp"
+
+using namespace budget;
+
+namespace {
+
+constexpr int64_t day_millis = 86400000;
+
+void write_json_string(budget::output_buffer& out, std::string_view value) {
+    out << '"';
+
+    for (const char c : value) {
+        switch (c) {
+            case '"':
+                out << "\\\"";
+                break;
+            case '\\':
+                out << "\\\\";
+                break;
+            case '\n':
+                out << "\\n";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out << ' ';
+                } else {
+                    out << c;
+                }
+        }
+    }
+
+    out << '"';
+}
+
+// A serie of daily values, in fixed point with two decimals
+struct data_serie {
+    std::string          name;
+    budget::date         first;
+    std::vector<int64_t> values;
+    std::vector<size_t>  days; // The day of each value, if not all the days are present
+};
+
+size_t day_of(const data_serie& serie, size_t j) {
+    return serie.days.empty() ? j : serie.days[j];
+}
+
+// The default number of points of the charts, 0 to disable downsampling
+size_t default_chart_points() {
+    static const size_t points = to_number<size_t>(config_value("server_chart_points", "0"));
+    return points;
+}
+
+// Downsample all the series of a chart at the same days, selected on their total.
+// The first day of each month and the last day are always kept exact.
+void downsample_series(std::vector<data_serie>& series, size_t target) {
+    if (series.empty() || !target) {
+        return;
+    }
+
+    const size_t size = series.front().values.size();
+
+    if (size <= target) {
+        return;
+    }
+
+    std::vector<double> total(size);
+    for (const auto& serie : series) {
+        for (size_t j = 0; j < size && j < serie.values.size(); ++j) {
+            total[j] += static_cast<double>(serie.values[j]);
+        }
+    }
+
+    std::vector<size_t> kept;
+
+    auto date = series.front().first;
+    for (size_t j = 0; j < size; ++j, date += days(1)) {
+        if (date.day() == 1) {
+            kept.push_back(j);
+        }
+    }
+
+    const auto selected = downsample(total, target, kept);
+
+    for (auto& serie : series) {
+        std::vector<int64_t> values;
+        values.reserve(selected.size());
+
+        for (auto j : selected) {
+            if (j < serie.values.size()) {
+                values.push_back(serie.values[j]);
+            }
+        }
+
+        serie.values = std::move(values);
+        serie.days   = selected;
+        serie.days.resize(serie.values.size());
+    }
+}
+
+data_serie make_data_serie(std::string name, const daily_serie& serie) {
+    data_serie data{std::move(name), serie.first, {}, {}};
+    data.values.reserve(serie.size());
+
+    // The money is already stored in cents
+    for (const auto& value : serie.values) {
+        data.values.push_back(value.value);
+    }
+
+    return data;
+}
+
+void write_fixed(budget::output_buffer& out, int64_t value) {
+    if (value < 0) {
+        out << '-';
+        value = -value;
+    }
+
+    out << value / 100 << '.' << static_cast<char>('0' + (value % 100) / 10) << static_cast<char>('0' + value % 10);
+}
+
+// Each serie as an array of epochs and an array of values
+void write_series(budget::output_buffer& out, const std::vector<data_serie>& series) {
+    out << R"({"series":[)";
+
+    for (size_t i = 0; i < series.size(); ++i) {
+        if (i) {
+            out << ',';
+        }
+
+        out << R"({"name":)";
+        write_json_string(out, series[i].name);
+
+        out << R"(,"epochs":[)";
+
+        const auto start = epoch_millis(series[i].first);
+
+        for (size_t j = 0; j < series[i].values.size(); ++j) {
+            if (j) {
+                out << ',';
+            }
+
+            out << start + static_cast<int64_t>(day_of(series[i], j)) * day_millis;
+        }
+
+        out << R"(],"values":[)";
+
+        for (size_t j = 0; j < series[i].values.size(); ++j) {
+            if (j) {
+                out << ',';
+            }
+
+            write_fixed(out, series[i].values[j]);
+        }
+
+        out << "]}";
+    }
+
+    out << "]}";
+}
+
+// Each serie as a start epoch, a fixed step and the deltas between the scaled values.
+// When downsampled, the offsets are the number of steps between the values.
+void write_columnar_series(budget::output_buffer& out, const std::vector<data_serie>& series) {
+    out << R"({"series":[)";
+
+    for (size_t i = 0; i < series.size(); ++i) {
+        if (i) {
+            out << ',';
+        }
+
+        out << R"({"name":)";
+        write_json_string(out, series[i].name);
+
+        out << R"(,"start":)" << epoch_millis(series[i].first);
+        out << R"(,"step":)" << day_millis;
+        out << R"(,"scale":100,"deltas":[)";
+
+        int64_t previous = 0;
+
+        for (size_t j = 0; j < series[i].values.size(); ++j) {
+            if (j) {
+                out << ',';
+            }
+
+            out << series[i].values[j] - previous;
+            previous = series[i].values[j];
+        }
+
+        out << ']';
+
+        if (!series[i].days.empty()) {
+            out << R"(,"offsets":[)";
+
+            for (size_t j = 0; j < series[i].days.size(); ++j) {
+                if (j) {
+                    out << ',';
+                }
+
+                out << series[i].days[j] - (j ? series[i].days[j - 1] : 0);
+            }
+
+            out << ']';
+        }
+
+        out << '}';
+    }
+
+    out << "]}";
+}
+
+std::vector<data_serie> class_series(bool portfolio) {
+    const auto snapshot = get_data_snapshot();
+    auto&      cache    = snapshot->cache;
+
+    auto series = asset_class_series(cache, portfolio);
+
+    std::vector<data_serie> data;
+    for (size_t i = 0; i < series.size(); ++i) {
+        data.push_back(make_data_serie(cache.asset_classes()[i].name, series[i]));
+    }
+
+    return data;
+}
+
+std::vector<data_serie> net_worth_daily_data(const httplib::Request& /*req*/) {
+    const auto snapshot = get_data_snapshot();
+    auto&      cache    = snapshot->cache;
+    return {make_data_serie("Net Worth", net_worth_serie(cache))};
+}
+
+std::vector<data_serie> fi_net_worth_daily_data(const httplib::Request& /*req*/) {
+    const auto snapshot = get_data_snapshot();
+    auto&      cache    = snapshot->cache;
+    return {make_data_serie("FI Net Worth", fi_net_worth_serie(cache))};
+}
+
+std::vector<data_serie> asset_daily_data(const httplib::Request& req) {
+    const auto snapshot = get_data_snapshot();
+    auto&      cache    = snapshot->cache;
+    return {make_data_serie("Value", asset_value_serie(cache, get_asset(to_number<size_t>(req.matches[1]))))};
+}
+
+std::vector<data_serie> asset_daily_conv_data(const httplib::Request& req) {
+    const auto snapshot = get_data_snapshot();
+    auto&      cache    = snapshot->cache;
+    return {make_data_serie("Value", asset_value_conv_serie(cache, get_asset(to_number<size_t>(req.matches[1]))))};
+}
+
+std::vector<data_serie> net_worth_allocation_data(const httplib::Request& /*req*/) {
+    return class_series(false);
+}
+
+std::vector<data_serie> portfolio_allocation_data(const httplib::Request& /*req*/) {
+    return class_series(true);
+}
+
+std::vector<data_serie> portfolio_daily_data(const httplib::Request& /*req*/) {
+    const auto snapshot = get_data_snapshot();
+    auto&      cache    = snapshot->cache;
+    return {make_data_serie("Portfolio", portfolio_serie(cache))};
+}
+
+std::vector<data_serie> currency_data(bool portfolio) {
+    const auto snapshot = get_data_snapshot();
+    auto&      cache    = snapshot->cache;
+
+    std::vector<data_serie> data;
+    for (const auto& [currency, serie] : currency_series(cache, portfolio)) {
+        data.push_back(make_data_serie(currency, serie));
+    }
+
+    return data;
+}
+
+std::vector<data_serie> net_worth_currency_data(const httplib::Request& /*req*/) {
+    return currency_data(false);
+}
+
+std::vector<data_serie> portfolio_currency_data(const httplib::Request& /*req*/) {
+    return currency_data(true);
+}
+
+std::vector<data_serie> fi_ratio_data(const httplib::Request& /*req*/) {
+    const auto snapshot = get_data_snapshot();
+    auto&      cache    = snapshot->cache;
+
+    std::vector<data_serie> series;
+
+    auto add_ratio_serie = [&cache, &series](std::string name, auto ratio_func) {
+        auto& serie = series.emplace_back(std::move(name), budget::asset_start_date(cache), std::vector<int64_t>{}, std::vector<size_t>{});
+
+        // The ratios are sent as percents
+        for (auto date = serie.first; date <= budget::local_day(); date += days(1)) {
+            serie.values.push_back(std::llround(100.0 * 100.0 * ratio_func(date)));
+        }
+    };
+
+    add_ratio_serie("FI Ratio (Current Expenses)", [&cache](budget::date date) { return budget::fi_ratio(date, cache); });
+
+    if (auto fixed_expenses = budget::get_fi_expenses(); fixed_expenses) {
+        add_ratio_serie(std::format("FI Ratio ({} {} yearly expenses)", fixed_expenses.dollars(), get_default_currency()),
+                        [&cache, fixed_expenses](budget::date date) { return budget::fixed_fi_ratio(date, cache, fixed_expenses); });
+    }
+
+    return series;
+}
+
+auto data_wrapper(std::vector<data_serie> (*data_function)(const httplib::Request&)) {
+    return [data_function](const httplib::Request& req, httplib::Response& res) {
+        if (!authenticate(req, res)) {
+            return;
+        }
+
+        const auto cached = make_cached_response(req);
+
+        if (serve_cached(req, res, cached, "application/json")) {
+            return;
+        }
+
+        budget::output_buffer content;
+
+        try {
+            auto series = [&req, data_function] {
+                auto data_lock = read_data();
+                return data_function(req);
+            }();
+
+            downsample_series(series, req.has_param("points") ? to_number<size_t>(req.get_param_value("points")) : default_chart_points());
+
+            if (req.get_param_value("format") == "columnar") {
+                write_columnar_series(content, series);
+            } else {
+                write_series(content, series);
+            }
+        } catch (const budget_exception& e) {
+            LOG_F(ERROR, "budget_exception occured in data({}): {}", req.path, e.message());
+            res.status = 500;
+            return;
+        } catch (const date_exception& e) {
+            LOG_F(ERROR, "date_exception occured in data({}): {}", req.path, e.message());
+            res.status = 500;
+            return;
+        } catch (const std::exception& e) {
+            LOG_F(ERROR, "std_exception occured in data({}): {}", req.path, e.what());
+            res.status = 500;
+            return;
+        }
+
+        res.set_content(std::move(content).str(), "application/json");
+
+        compress_response(req, res);
+        set_validators(res, cached);
+        cache_response(res, cached);
+    };
+}
+
+} // end of anonymous namespace
+
+void budget::load_data_pages(httplib::Server& server) {
+    server.Get("/data/net_worth/daily/", data_wrapper(&net_worth_daily_data));
+    server.Get("/data/fi_net_worth/daily/", data_wrapper(&fi_net_worth_daily_data));
+    server.Get("/data/net_worth/allocation/", data_wrapper(&net_worth_allocation_data));
+    server.Get("/data/portfolio/allocation/", data_wrapper(&portfolio_allocation_data));
+    server.Get(R"(/data/asset/daily/(\d+)/)", data_wrapper(&asset_daily_data));
+    server.Get(R"(/data/asset/daily_conv/(\d+)/)", data_wrapper(&asset_daily_conv_data));
+    server.Get("/data/portfolio/daily/", data_wrapper(&portfolio_daily_data));
+    server.Get("/data/net_worth/currency/", data_wrapper(&net_worth_currency_data));
+    server.Get("/data/portfolio/currency/", data_wrapper(&portfolio_currency_data));
+    server.Get("/data/retirement/fi_ratio/", data_wrapper(&fi_ratio_data));
+}
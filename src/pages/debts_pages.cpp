@@ -10,6 +10,7 @@
 #include "pages/html_writer.hpp"
 #include "pages/debts_pages.hpp"
 #include "http.hpp"
+#include "lazy_data.hpp"
 
 using namespace budget;
 
@@ -43,18 +44,24 @@ void add_direction_picker(budget::writer& w, std::string_view default_value = ""
 } // end of anonymous namespace
 
 void budget::list_debts_page(html_writer& w) {
+    require_debts();
+
     budget::list_debts(w);
 
     make_tables_sortable(w);
 }
 
 void budget::all_debts_page(html_writer& w) {
+    require_debts();
+
     budget::display_all_debts(w);
 
     make_tables_sortable(w);
 }
 
 void budget::add_debts_page(html_writer& w) {
+    require_debts();
+
     w << title_begin << "New Debt" << title_end;
 
     form_begin(w, "/api/debts/add/", "/debts/add/");
@@ -68,6 +75,8 @@ void budget::add_debts_page(html_writer& w) {
 }
 
 void budget::edit_debts_page(html_writer& w, const httplib::Request& req) {
+    require_debts();
+
     if (!validate_parameters(w, req, {"input_id", "back_page"})) {
         return;
     }
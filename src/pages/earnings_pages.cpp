@@ -52,11 +52,11 @@ void budget::month_breakdown_income_graph(
 
     std::map<size_t, budget::money, std::less<>> account_sum;
 
-    for (auto& earning : all_earnings_month(w.cache, year, month)) {
+    for (auto& earning : all_earnings_month(w.data(), year, month)) {
         account_sum[earning.account] += earning.amount;
     }
 
-    budget::money total = get_base_income(w.cache);
+    budget::money total = get_base_income(w.data());
 
     if (total) {
         ss << "{";
@@ -114,14 +114,14 @@ void budget::time_graph_income_page(html_writer& w) {
         std::vector<budget::money> serie;
         std::vector<std::string>   dates;
 
-        auto sy = start_year(w.cache);
+        auto sy = start_year(w.data());
 
         for (budget::year year = sy; year <= budget::local_day().year(); ++year) {
-            const auto sm   = start_month(w.cache, year);
+            const auto sm   = start_month(w.data(), year);
             const auto last = last_month(year);
 
             for (budget::month month = sm; month < last; ++month) {
-                auto sum = get_base_income(w.cache, budget::date(year, month, 2)) + fold_left_auto(all_earnings_month(w.cache, year, month) | to_amount);
+                auto sum = get_base_income(w.data(), budget::date(year, month, 2)) + fold_left_auto(all_earnings_month(w.data(), year, month) | to_amount);
 
                 const std::string date = std::format("Date.UTC({},{},1)", year.value, month.value - 1);
 
@@ -157,16 +157,16 @@ void budget::time_graph_income_page(html_writer& w) {
         std::vector<budget::money> serie;
         std::vector<std::string>   dates;
 
-        auto sy = start_year(w.cache);
+        auto sy = start_year(w.data());
 
         for (budget::year year = sy; year <= budget::local_day().year(); ++year) {
-            const auto sm   = start_month(w.cache, year);
+            const auto sm   = start_month(w.data(), year);
             const auto last = last_month(year);
 
             budget::money sum;
 
             for (budget::month m = sm; m < last; ++m) {
-                sum += get_base_income(w.cache, budget::date(year, m, 2)) + fold_left_auto(all_earnings_month(w.cache, year, m) | to_amount);
+                sum += get_base_income(w.data(), budget::date(year, m, 2)) + fold_left_auto(all_earnings_month(w.data(), year, m) | to_amount);
             }
 
             const std::string date = std::format("Date.UTC({},1,1)", year.value);
@@ -199,14 +199,14 @@ void budget::time_graph_earnings_page(html_writer& w) {
     ss << "{ name: 'Monthly earnings',";
     ss << "data: [";
 
-    auto sy = start_year(w.cache);
+    auto sy = start_year(w.data());
 
     for (budget::year year = sy; year <= budget::local_day().year(); ++year) {
-        const auto sm   = start_month(w.cache, year);
+        const auto sm   = start_month(w.data(), year);
         const auto last = last_month(year);
 
         for (budget::month month = sm; month < last; ++month) {
-            const auto sum = fold_left_auto(all_earnings_month(w.cache, year, month) | to_amount);
+            const auto sum = fold_left_auto(all_earnings_month(w.data(), year, month) | to_amount);
 
             ss << "[Date.UTC(" << year << "," << month.value - 1 << ", 1) ," << budget::money_to_string(sum) << "],";
         }
@@ -237,12 +237,12 @@ void add_quick_earning_action(budget::html_writer& w, size_t i, const budget::ea
 void budget::add_earnings_page(html_writer& w) {
     w << title_begin << "New earning" << title_end;
 
-    if (w.cache.earnings().size() > quick_actions) {
+    if (w.data().earnings().size() > quick_actions) {
         std::map<std::string, size_t, std::less<>>                    counts;
         cpp::string_hash_map<budget::earning> last_earnings;
         std::vector<std::pair<std::string, size_t>>      order;
 
-        for (const auto& earning : w.cache.sorted_earnings()) {
+        for (const auto& earning : w.data().sorted_earnings()) {
             ++counts[earning.name];
             last_earnings[earning.name] = earning;
         }
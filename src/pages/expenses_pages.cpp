@@ -76,7 +76,7 @@ void budget::month_breakdown_expenses_graph(
 
         std::map<size_t, budget::money, std::less<>> account_sum;
 
-        for (auto& expense : all_expenses_month(w.cache, year, month)) {
+        for (auto& expense : all_expenses_month(w.data(), year, month)) {
             account_sum[expense.account] += expense.amount;
         }
 
@@ -129,7 +129,7 @@ void budget::month_breakdown_expenses_graph(
 
         std::map<std::string, budget::money, std::less<>> expense_sum;
 
-        for (auto& expense : all_expenses_month(w.cache, year, month)) {
+        for (auto& expense : all_expenses_month(w.data(), year, month)) {
             expense_sum[expense.name] += expense.amount;
         }
 
@@ -169,7 +169,7 @@ void budget::month_breakdown_expenses_graph(
 
         std::map<std::string, budget::money, std::less<>> expense_sum;
 
-        for (auto& expense : all_expenses_month(w.cache, year, month)) {
+        for (auto& expense : all_expenses_month(w.data(), year, month)) {
             auto name = expense.name;
 
             if (name[name.size() - 1] == ' ') {
@@ -232,7 +232,7 @@ void budget::search_expenses_page(html_writer& w, const httplib::Request& req) {
 }
 
 void budget::time_graph_expenses_page(html_writer& w) {
-    auto sy = start_year(w.cache);
+    auto sy = start_year(w.data());
 
     {
         auto ss = start_time_chart(w, "Expenses over time", "line", "expenses_time_graph", "");
@@ -250,11 +250,11 @@ void budget::time_graph_expenses_page(html_writer& w) {
         std::vector<std::string>   dates;
 
         for (budget::year year = sy; year <= budget::local_day().year(); ++year) {
-            const auto sm   = start_month(w.cache, year);
+            const auto sm   = start_month(w.data(), year);
             const auto last = last_month(year);
 
             for (budget::month month = sm; month < last; ++month) {
-                budget::money const sum = fold_left_auto(all_expenses_month(w.cache, year, month) | to_amount);
+                budget::money const sum = fold_left_auto(all_expenses_month(w.data(), year, month) | to_amount);
 
                 const std::string date = std::format("Date.UTC({},{},1)", year.value, month.value - 1);
 
@@ -295,13 +295,13 @@ void budget::time_graph_expenses_page(html_writer& w) {
         std::vector<std::string>   dates;
 
         for (budget::year year = sy; year <= budget::local_day().year(); ++year) {
-            const auto sm   = start_month(w.cache, year);
+            const auto sm   = start_month(w.data(), year);
             const auto last = last_month(year);
 
             for (budget::month month =  sm; month < last; ++month) {
                 budget::money sum;
 
-                for (auto& expense : all_expenses_month(w.cache, year, month)) {
+                for (auto& expense : all_expenses_month(w.data(), year, month)) {
                     if (get_account(expense.account).name != taxes_account_name) {
                         sum += expense.amount;
                     }
@@ -375,7 +375,7 @@ void budget::year_breakdown_expenses_page(html_writer& w, const httplib::Request
 
         std::map<std::string, budget::money, std::less<>> account_sum;
 
-        for (auto& expense : all_expenses_year(w.cache, year)) {
+        for (auto& expense : all_expenses_year(w.data(), year)) {
             account_sum[get_account(expense.account).name] += expense.amount;
         }
 
@@ -408,7 +408,7 @@ void budget::year_breakdown_expenses_page(html_writer& w, const httplib::Request
 
         std::map<std::string, budget::money, std::less<>> expense_sum;
 
-        for (auto& expense : all_expenses_year(w.cache, year)) {
+        for (auto& expense : all_expenses_year(w.data(), year)) {
             expense_sum[expense.name] += expense.amount;
         }
 
@@ -445,7 +445,7 @@ void budget::year_breakdown_expenses_page(html_writer& w, const httplib::Request
 
         std::map<std::string, budget::money, std::less<>> expense_sum;
 
-        for (auto& expense : all_expenses_year(w.cache, year)) {
+        for (auto& expense : all_expenses_year(w.data(), year)) {
             auto name = expense.name;
 
             if (name[name.size() - 1] == ' ') {
@@ -495,12 +495,12 @@ void add_quick_expense_action(budget::html_writer& w, size_t i, const budget::ex
 void budget::add_expenses_page(html_writer& w) {
     w << title_begin << "New Expense" << title_end;
 
-    if (w.cache.expenses().size() > quick_actions) {
+    if (w.data().expenses().size() > quick_actions) {
         std::map<std::string, size_t, std::less<>>                    counts;
         cpp::string_hash_map<budget::expense> last_expenses;
         std::vector<std::pair<std::string, size_t>>      order;
 
-        for (const auto& expense : w.cache.sorted_expenses() | persistent) {
+        for (const auto& expense : w.data().sorted_expenses() | persistent) {
             ++counts[expense.name];
             last_expenses[expense.name] = expense;
         }
@@ -577,7 +577,7 @@ void import_expenses_page(html_writer& w, std::string_view name) {
 
     form_end(w);
 
-    if (std::ranges::empty(w.cache.expenses() | temporary)) {
+    if (std::ranges::empty(w.data().expenses() | temporary)) {
         return;
     }
 
@@ -606,7 +606,7 @@ void import_expenses_page(html_writer& w, std::string_view name) {
     w << "<tbody>";
 
     size_t n_expenses = 0;
-    for (auto & expense : w.cache.expenses() | temporary) {
+    for (auto & expense : w.data().expenses() | temporary) {
         w << "<tr>";
 
         // The id in the DB
@@ -10,16 +10,21 @@
 #include "pages/fortunes_pages.hpp"
 #include "pages/html_writer.hpp"
 #include "http.hpp"
+#include "lazy_data.hpp"
 
 using namespace budget;
 
 void budget::list_fortunes_page(html_writer& w) {
+    require_fortunes();
+
     budget::list_fortunes(w);
 
     make_tables_sortable(w);
 }
 
 void budget::graph_fortunes_page(html_writer& w) {
+    require_fortunes();
+
     auto ss = start_chart(w, "Fortune", "spline");
 
     ss << R"=====(xAxis: { type: 'datetime', title: { text: 'Date' }},)=====";
@@ -48,12 +53,16 @@ void budget::graph_fortunes_page(html_writer& w) {
 }
 
 void budget::status_fortunes_page(html_writer& w) {
+    require_fortunes();
+
     budget::status_fortunes(w, false);
 
     make_tables_sortable(w);
 }
 
 void budget::add_fortunes_page(html_writer& w) {
+    require_fortunes();
+
     w << title_begin << "New fortune" << title_end;
 
     form_begin(w, "/api/fortunes/add/", "/fortunes/add/");
@@ -65,6 +74,8 @@ void budget::add_fortunes_page(html_writer& w) {
 }
 
 void budget::edit_fortunes_page(html_writer& w, const httplib::Request& req) {
+    require_fortunes();
+
     if (!validate_parameters(w, req, {"input_id", "back_page"})) {
         return;
     }
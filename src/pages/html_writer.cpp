@@ -271,7 +271,7 @@ budget::writer& budget::html_writer::operator<<(const budget::year_month_selecto
 
     os << "</div>";
 
-    std::stringstream ss;
+    budget::output_buffer ss;
 
     ss << "var update_page = function(){";
     ss << "var selected_year = $(\"#year_selector\").find(':selected');";
@@ -282,7 +282,7 @@ budget::writer& budget::html_writer::operator<<(const budget::year_month_selecto
     ss << "$('#year_selector').change(update_page);";
     ss << "$('#month_selector').change(update_page);";
 
-    defer_script(ss.str());
+    defer_script(std::move(ss).str());
 
     use_module("open-iconic");
 
@@ -320,7 +320,7 @@ budget::writer& budget::html_writer::operator<<(const budget::year_selector& m)
 
     os << "</div>";
 
-    std::stringstream ss;
+    budget::output_buffer ss;
 
     ss << "$('#year_selector').change(function(){";
     ss << "var selected = $(this).find(':selected');";
@@ -328,7 +328,7 @@ budget::writer& budget::html_writer::operator<<(const budget::year_selector& m)
        << R"(" + selected.val() + "/";)";
     ss << "})";
 
-    defer_script(ss.str());
+    defer_script(std::move(ss).str());
 
     use_module("open-iconic");
 
@@ -376,7 +376,7 @@ budget::writer& budget::html_writer::operator<<(const budget::asset_selector& m)
 
     os << "</div>";
 
-    std::stringstream ss;
+    budget::output_buffer ss;
 
     ss << "$('#asset_selector').change(function(){";
     ss << "var selected = $(this).find(':selected');";
@@ -384,7 +384,7 @@ budget::writer& budget::html_writer::operator<<(const budget::asset_selector& m)
        << R"(" + selected.val() + "/";)";
     ss << "})";
 
-    defer_script(ss.str());
+    defer_script(std::move(ss).str());
 
     use_module("open-iconic");
 
@@ -432,7 +432,7 @@ budget::writer& budget::html_writer::operator<<(const budget::active_asset_selec
 
     os << "</div>";
 
-    std::stringstream ss;
+    budget::output_buffer ss;
 
     ss << "$('#asset_selector').change(function(){";
     ss << "var selected = $(this).find(':selected');";
@@ -440,7 +440,7 @@ budget::writer& budget::html_writer::operator<<(const budget::active_asset_selec
        << R"(" + selected.val() + "/";)";
     ss << "})";
 
-    defer_script(ss.str());
+    defer_script(std::move(ss).str());
 
     use_module("open-iconic");
 
@@ -652,8 +652,7 @@ void budget::html_writer::display_graph(std::string_view                 title,
 
     os << R"=====(<div id="container" style="min-width: 310px; height: 400px; margin: 0 auto"></div>)=====";
 
-    std::stringstream ss;
-    ss.imbue(std::locale("C"));
+    budget::output_buffer ss;
 
     ss << R"=====(Highcharts.chart('container', {)=====";
     ss << R"=====(chart: {type: 'column'},)=====";
@@ -685,19 +684,20 @@ void budget::html_writer::display_graph(std::string_view                 title,
 
     ss << R"=====(});)=====";
 
-    defer_script(ss.str());
+    defer_script(std::move(ss).str());
 }
 
-void budget::html_writer::defer_script(const std::string& script) {
-    std::stringstream ss;
+budget::data_cache& budget::html_writer::data() {
+    if (!snapshot) {
+        snapshot = get_data_snapshot();
+    }
 
-    ss << R"=====(<script>)=====" << '\n';
-    ss << R"=====($(function(){)=====" << '\n';
-    ss << script;
-    ss << R"=====(});)=====";
-    ss << R"=====(</script>)=====";
+    return snapshot->cache;
+}
 
-    scripts.emplace_back(ss.str());
+void budget::html_writer::defer_script(std::string script) {
+    // The script is wrapped when written out, to avoid copying large scripts
+    scripts.emplace_back(std::move(script));
 }
 
 void budget::html_writer::load_deferred_scripts() {
@@ -732,10 +732,55 @@ void budget::html_writer::load_deferred_scripts() {
         )=====";
     }
 
+    // The series of the charts fetched asynchronously
+    if (need_module("data-series")) {
+        os << R"=====(
+            <script>
+            function budget_fetch_series(id, url) {
+                fetch(url + '?format=columnar', {credentials: 'same-origin'}).then(function (response) {
+                    return response.json();
+                }).then(function (data) {
+                    var chart = Highcharts.charts.find(function (c) { return c && c.renderTo.id === id; });
+
+                    data.series.forEach(function (serie) {
+                        var points = [];
+                        var value  = 0;
+                        var day    = 0;
+
+                        serie.deltas.forEach(function (delta, i) {
+                            value += delta;
+
+                            if (serie.offsets) {
+                                day += serie.offsets[i];
+                            } else if (i) {
+                                day += 1;
+                            }
+
+                            points.push([serie.start + day * serie.step, value / serie.scale]);
+                        });
+
+                        chart.addSeries({name: serie.name, data: points}, false);
+                    });
+
+                    chart.redraw();
+                });
+            }
+            </script>
+        )=====";
+    }
+
     // Add the custom scripts
     for (auto& script : scripts) {
-        os << script << '\n';
+        os << R"=====(<script>)=====" << '\n';
+        os << R"=====($(function(){)=====" << '\n';
+        os << script;
+        os << R"=====(});)=====";
+        os << R"=====(</script>)=====" << '\n';
+
+        release_buffer(std::move(script));
     }
+
+    scripts.clear();
 }
 
 void budget::html_writer::use_module(const std::string& module) {
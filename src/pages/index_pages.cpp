@@ -12,6 +12,7 @@
 #include "pages/objectives_pages.hpp"
 #include "pages/net_worth_pages.hpp"
 #include "pages/html_writer.hpp"
+#include "pages/trace.hpp"
 #include "http.hpp"
 #include "config.hpp"
 #include "views.hpp"
@@ -30,6 +31,8 @@ budget::money monthly_spending(data_cache& cache, budget::month month, budget::y
 }
 
 void cash_flow_card(budget::html_writer& w) {
+    BUDGET_TRACE_SPAN("cash_flow_card");
+
     const auto today = budget::local_day();
 
     const auto m = today.month();
@@ -37,8 +40,8 @@ void cash_flow_card(budget::html_writer& w) {
 
     w << R"=====(<div class="card">)=====";
 
-    auto income   = monthly_income(w.cache, m, y);
-    auto spending = monthly_spending(w.cache, m, y);
+    auto income   = monthly_income(w.data(), m, y);
+    auto spending = monthly_spending(w.data(), m, y);
 
     w << R"=====(<div class="card-header card-header-primary">)=====";
     w << R"=====(<div class="float-left">Cash Flow</div>)=====";
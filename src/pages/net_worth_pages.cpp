@@ -9,6 +9,8 @@
 
 #include "pages/html_writer.hpp"
 #include "pages/net_worth_pages.hpp"
+#include "pages/time_series.hpp"
+#include "pages/trace.hpp"
 #include "http.hpp"
 #include "currency.hpp"
 #include "config.hpp"
@@ -18,6 +20,8 @@
 using namespace budget;
 
 void budget::assets_card(budget::html_writer& w) {
+    BUDGET_TRACE_SPAN("assets_card");
+
     w << R"=====(<div class="card">)=====";
 
     w << R"=====(<div class="card-header card-header-primary">)=====";
@@ -37,7 +41,7 @@ void budget::assets_card(budget::html_writer& w) {
 
     // If one asset has no group, we disable grouping
     if (group_style) {
-        for (const auto& [asset, amount] : w.cache.user_assets() | expand_value(w.cache) | not_zero) {
+        for (const auto& [asset, amount] : w.data().user_assets() | expand_value(w.data()) | not_zero) {
             auto pos = asset.name.find(separator);
             if (pos == 0 || pos == std::string::npos) {
                 group_style = false;
@@ -50,7 +54,7 @@ void budget::assets_card(budget::html_writer& w) {
         std::vector<std::string> groups;
         std::unordered_map<std::string, budget::money> group_sums;
 
-        for (const auto& [asset, amount] : w.cache.user_assets() | expand_value(w.cache) | not_zero) {
+        for (const auto& [asset, amount] : w.data().user_assets() | expand_value(w.data()) | not_zero) {
             std::string group = asset.name.substr(0, asset.name.find(separator));
 
             if (amount) {
@@ -65,7 +69,7 @@ void budget::assets_card(budget::html_writer& w) {
         for (const auto& group : groups) {
             bool started = false;
 
-            for (const auto& [asset, amount] : w.cache.user_assets() | expand_value(w.cache) | not_zero) {
+            for (const auto& [asset, amount] : w.data().user_assets() | expand_value(w.data()) | not_zero) {
                 if (asset.name.substr(0, asset.name.find(separator)) == group) {
                     auto short_name = asset.name.substr(asset.name.find(separator) + 1);
 
@@ -94,7 +98,7 @@ void budget::assets_card(budget::html_writer& w) {
     } else {
         bool first = true;
 
-        for (const auto& [asset, amount] : w.cache.user_assets() | expand_value(w.cache) | not_zero) {
+        for (const auto& [asset, amount] : w.data().user_assets() | expand_value(w.data()) | not_zero) {
             if (!first) {
                 w << R"=====(<hr />)=====";
             }
@@ -118,7 +122,9 @@ void budget::assets_card(budget::html_writer& w) {
 }
 
 void budget::liabilities_card(budget::html_writer& w) {
-    if (w.cache.liabilities().empty()) {
+    BUDGET_TRACE_SPAN("liabilities_card");
+
+    if (w.data().liabilities().empty()) {
         return;
     }
 
@@ -137,7 +143,7 @@ void budget::liabilities_card(budget::html_writer& w) {
 
     bool first = true;
 
-    for (const auto& [liability, amount] : w.cache.liabilities() | expand_value(w.cache) | not_zero) {
+    for (const auto& [liability, amount] : w.data().liabilities() | expand_value(w.data()) | not_zero) {
         if (!first) {
             w << R"=====(<hr />)=====";
         }
@@ -160,7 +166,7 @@ void budget::liabilities_card(budget::html_writer& w) {
 }
 
 void budget::asset_graph_page(html_writer& w, const httplib::Request& req) {
-    auto asset = req.matches.size() == 2 ? get_asset(to_number<size_t>(req.matches[1])) : *w.cache.active_user_assets().begin();
+    auto asset = req.matches.size() == 2 ? get_asset(to_number<size_t>(req.matches[1])) : *w.data().active_user_assets().begin();
 
     if (req.matches.size() == 2) {
         w << title_begin << "Asset Graph" << budget::active_asset_selector{"assets/graph", to_number<size_t>(req.matches[1])} << title_end;
@@ -269,31 +275,11 @@ void budget::asset_graph(budget::html_writer& w, std::string_view style, const a
     ss << R"=====(legend: { enabled: false },)=====";
 
     ss << R"=====(subtitle: {)=====";
-    ss << "text: '" << get_asset_value(asset, w.cache) << " " << asset.currency << "',";
+    ss << "text: '" << get_asset_value(asset, w.data()) << " " << asset.currency << "',";
     ss << R"=====(floating:true, align:"right", verticalAlign: "top", style: { fontWeight: "bold", fontSize: "inherit" })=====";
     ss << R"=====(},)=====";
 
-    ss << "series: [";
-
-    ss << "{ name: 'Value',";
-    ss << "data: [";
-
-    auto date     = budget::asset_start_date(w.cache, asset);
-    auto end_date = budget::local_day();
-
-    while (date <= end_date) {
-        auto sum = get_asset_value(asset, date, w.cache);
-
-        ss << "[Date.UTC(" << date.year() << "," << date.month().value - 1 << "," << date.day() << ") ," << budget::money_to_string(sum) << "],";
-
-        date += days(1);
-    }
-
-    ss << "]},";
-
-    ss << "]";
-
-    end_chart(w, ss);
+    end_data_chart(w, ss, "asset_graph", std::format("/data/asset/daily/{}/", asset.id));
 }
 
 void budget::asset_graph_conv(budget::html_writer& w, std::string_view style, const asset& asset) {
@@ -304,46 +290,27 @@ void budget::asset_graph_conv(budget::html_writer& w, std::string_view style, co
     ss << R"=====(legend: { enabled: false },)=====";
 
     ss << R"=====(subtitle: {)=====";
-    ss << "text: '" << get_asset_value_conv(asset, w.cache) << " " << get_default_currency() << "',";
+    ss << "text: '" << get_asset_value_conv(asset, w.data()) << " " << get_default_currency() << "',";
     ss << R"=====(floating:true, align:"right", verticalAlign: "top", style: { fontWeight: "bold", fontSize: "inherit" })=====";
     ss << R"=====(},)=====";
 
-    ss << "series: [";
-
-    ss << "{ name: 'Value',";
-    ss << "data: [";
-
-    auto date     = budget::asset_start_date(w.cache, asset);
-    auto end_date = budget::local_day();
-
-    while (date <= end_date) {
-        auto sum = get_asset_value_conv(asset, date, w.cache);
-
-        ss << "[Date.UTC(" << date.year() << "," << date.month().value - 1 << "," << date.day() << ") ," << budget::money_to_string(sum) << "],";
-
-        date += days(1);
-    }
-
-    ss << "]},";
-
-    ss << "]";
-
-    end_chart(w, ss);
+    end_data_chart(w, ss, "asset_graph_conv", std::format("/data/asset/daily_conv/{}/", asset.id));
 }
 
 namespace {
 
 template <typename Functor>
-void net_worth_graph(budget::html_writer& w, std::string_view title, std::string_view style, bool card, Functor nw_func) {
+void net_worth_graph(budget::html_writer& w, std::string_view title, std::string_view style, bool card, std::string_view url, Functor nw_func) {
     // if the user does not use assets, this graph does not make sense
     if (no_assets() || no_asset_values()) {
         return;
     }
 
+    // Only three values are needed here, the series are served by the data endpoint
     auto now               = budget::local_day();
-    auto current_net_worth = nw_func(now, w.cache);
-    auto y_net_worth       = nw_func({now.year(), 1, 1}, w.cache);
-    auto m_net_worth       = nw_func(now - days(now.day() - 1), w.cache);
+    auto current_net_worth = nw_func(now, w.data());
+    auto y_net_worth       = nw_func({now.year(), 1, 1}, w.data());
+    auto m_net_worth       = nw_func(now - days(now.day() - 1), w.data());
     auto ytd_growth        = 100.0 * ((1 / (y_net_worth / current_net_worth)) - 1);
     auto mtd_growth        = 100.0 * ((1 / (m_net_worth / current_net_worth)) - 1);
 
@@ -382,27 +349,7 @@ void net_worth_graph(budget::html_writer& w, std::string_view title, std::string
         ss << R"=====(},)=====";
     }
 
-    ss << "series: [";
-
-    ss << "{ name: '" << title << "',";
-    ss << "data: [";
-
-    auto date     = budget::asset_start_date(w.cache);
-    auto end_date = budget::local_day();
-
-    while (date <= end_date) {
-        auto sum = nw_func(date, w.cache);
-
-        ss << "[Date.UTC(" << date.year() << "," << date.month().value - 1 << "," << date.day() << ") ," << budget::money_to_string(sum) << "],";
-
-        date += days(1);
-    }
-
-    ss << "]},";
-
-    ss << "]";
-
-    end_chart(w, ss);
+    end_data_chart(w, ss, "net_worth_graph", url);
 
     if (card) {
         w << R"=====(</div>)====="; // card-body
@@ -413,11 +360,13 @@ void net_worth_graph(budget::html_writer& w, std::string_view title, std::string
 } // namespace
 
 void budget::net_worth_graph(budget::html_writer& w, std::string_view style, bool card) {
-    ::net_worth_graph(w, "Net Worth", style, card, [](budget::date d, budget::data_cache& cache) { return get_net_worth(d, cache); });
+    BUDGET_TRACE_SPAN("net_worth_graph");
+
+    ::net_worth_graph(w, "Net Worth", style, card, "/data/net_worth/daily/", [](budget::date d, budget::data_cache& cache) { return get_net_worth(d, cache); });
 }
 
 void budget::fi_net_worth_graph(budget::html_writer& w, std::string_view style, bool card) {
-    ::net_worth_graph(w, "FI Net Worth", style, card, [](budget::date d, budget::data_cache& cache) { return get_fi_net_worth(d, cache); });
+    ::net_worth_graph(w, "FI Net Worth", style, card, "/data/fi_net_worth/daily/", [](budget::date d, budget::data_cache& cache) { return get_fi_net_worth(d, cache); });
 }
 
 void budget::net_worth_accrual_graph(budget::html_writer& w) {
@@ -437,20 +386,20 @@ void budget::net_worth_accrual_graph(budget::html_writer& w) {
     ss << "{ type: 'column', name: 'Net Worth Growth', negativeColor: 'red',";
     ss << "data: [";
 
-    auto date     = budget::asset_start_date(w.cache);
+    auto date     = budget::asset_start_date(w.data());
     auto end_date = budget::local_day();
 
     // We need to skip the first month
     date += months(1);
 
+    const auto net_worth = net_worth_serie(w.data());
+
     std::vector<budget::money> serie;
     std::vector<std::string>   dates;
 
     while (date <= end_date) {
-        budget::money const sum;
-
-        auto start = get_net_worth(date.start_of_month(), w.cache);
-        auto end   = get_net_worth(date.end_of_month(), w.cache);
+        auto start = net_worth.at(date.start_of_month());
+        auto end   = net_worth.at(date.end_of_month());
 
         std::string const date_str = std::format("Date.UTC({},{},1)", date.year().value, date.month().value - 1);
         ss << "[" << date_str << " ," << budget::money_to_string(end - start) << "],";
@@ -485,10 +434,10 @@ void budget::net_worth_graph_page(html_writer& w) {
 
     // Then, we can display some general information
 
-    auto current_net_worth = get_net_worth(w.cache);
+    auto current_net_worth = get_net_worth(w.data());
     auto now               = budget::local_day();
-    auto y_net_worth       = get_net_worth({now.year(), 1, 1}, w.cache);
-    auto m_net_worth       = get_net_worth(now - days(now.day() - 1), w.cache);
+    auto y_net_worth       = get_net_worth({now.year(), 1, 1}, w.data());
+    auto m_net_worth       = get_net_worth(now - days(now.day() - 1), w.data());
     auto ytd_growth        = 100.0 * ((1 / (y_net_worth / current_net_worth)) - 1);
     auto mtd_growth        = 100.0 * ((1 / (m_net_worth / current_net_worth)) - 1);
 
@@ -509,9 +458,9 @@ void budget::fi_net_worth_graph_page(html_writer& w) {
     // Then, we can display some general information
 
     auto now               = budget::local_day();
-    auto current_net_worth = get_fi_net_worth(now, w.cache);
-    auto y_net_worth       = get_fi_net_worth({now.year(), 1, 1}, w.cache);
-    auto m_net_worth       = get_fi_net_worth(now - days(now.day() - 1), w.cache);
+    auto current_net_worth = get_fi_net_worth(now, w.data());
+    auto y_net_worth       = get_fi_net_worth({now.year(), 1, 1}, w.data());
+    auto m_net_worth       = get_fi_net_worth(now - days(now.day() - 1), w.data());
     auto ytd_growth        = 100.0 * ((1 / (y_net_worth / current_net_worth)) - 1);
     auto mtd_growth        = 100.0 * ((1 / (m_net_worth / current_net_worth)) - 1);
 
@@ -524,12 +473,18 @@ void budget::fi_net_worth_graph_page(html_writer& w) {
 
 namespace {
 
-budget::money get_class_sum(data_cache& cache, const budget::asset_class& clas, budget::date date) {
+budget::money get_class_sum(data_cache& cache, const budget::asset_class& clas, budget::date date, bool portfolio) {
     budget::money sum;
 
     // Add the value of the assets for this class
     for (const auto& asset : cache.user_assets()) {
-        sum += get_asset_value_conv(asset, date, cache) * (float(get_asset_class_allocation(asset, clas)) / 100.0f);
+        if (!portfolio || asset.portfolio) {
+            sum += get_asset_value_conv(asset, date, cache) * (float(get_asset_class_allocation(asset, clas)) / 100.0f);
+        }
+    }
+
+    if (portfolio) {
+        return sum;
     }
 
     // Remove the value of the liabilities for this class
@@ -552,29 +507,7 @@ void budget::net_worth_allocation_page(html_writer& w) {
     ss << R"=====(tooltip: {split: true},)=====";
     ss << R"=====(plotOptions: {area: {stacking: 'percent'}},)=====";
 
-    ss << "series: [";
-
-    for (auto& clas : w.cache.asset_classes()) {
-        ss << "{ name: '" << clas.name << "',";
-        ss << "data: [";
-
-        auto date     = budget::asset_start_date(w.cache);
-        auto end_date = budget::local_day();
-
-        while (date <= end_date) {
-            auto sum = get_class_sum(w.cache, clas, date);
-
-            ss << "[Date.UTC(" << date.year() << "," << date.month().value - 1 << "," << date.day() << ") ," << budget::money_to_string(sum) << "],";
-
-            date += days(1);
-        }
-
-        ss << "]},";
-    }
-
-    ss << "]";
-
-    end_chart(w, ss);
+    end_data_chart(w, ss, "allocation_time_graph", "/data/net_worth/allocation/");
 
     // 2. Display the current currency breakdown
 
@@ -588,11 +521,11 @@ void budget::net_worth_allocation_page(html_writer& w) {
     ss2 << "colorByPoint: true,";
     ss2 << "data: [";
 
-    for (auto& clas : w.cache.asset_classes()) {
+    for (auto& clas : w.data().asset_classes()) {
         ss2 << "{ name: '" << clas.name << "',";
         ss2 << "y: ";
 
-        auto sum = get_class_sum(w.cache, clas, budget::local_day());
+        auto sum = get_class_sum(w.data(), clas, budget::local_day(), false);
         ss2 << budget::money_to_string(sum);
 
         ss2 << "},";
@@ -615,33 +548,7 @@ void budget::portfolio_allocation_page(html_writer& w) {
     ss << R"=====(tooltip: {split: true},)=====";
     ss << R"=====(plotOptions: {area: {stacking: 'percent'}},)=====";
 
-    ss << "series: [";
-
-    for (auto& clas : w.cache.asset_classes()) {
-        ss << "{ name: '" << clas.name << "',";
-        ss << "data: [";
-
-        auto date     = budget::asset_start_date(w.cache);
-        auto end_date = budget::local_day();
-
-        while (date <= end_date) {
-            budget::money sum;
-
-            for (const auto& asset : w.cache.user_assets() | is_portfolio) {
-                sum += get_asset_value_conv(asset, date, w.cache) * (float(get_asset_class_allocation(asset, clas)) / 100.0f);
-            }
-
-            ss << "[Date.UTC(" << date.year() << "," << date.month().value - 1 << "," << date.day() << ") ," << budget::money_to_string(sum) << "],";
-
-            date += days(1);
-        }
-
-        ss << "]},";
-    }
-
-    ss << "]";
-
-    end_chart(w, ss);
+    end_data_chart(w, ss, "allocation_time_graph", "/data/portfolio/allocation/");
 
     // 2. Display the current currency breakdown
 
@@ -655,16 +562,11 @@ void budget::portfolio_allocation_page(html_writer& w) {
     ss2 << "colorByPoint: true,";
     ss2 << "data: [";
 
-    for (auto& clas : w.cache.asset_classes()) {
+    for (auto& clas : w.data().asset_classes()) {
         ss2 << "{ name: '" << clas.name << "',";
         ss2 << "y: ";
 
-        budget::money sum;
-
-        for (const auto& asset : w.cache.user_assets() | is_portfolio) {
-            sum += get_asset_value_conv(asset, w.cache) * (float(get_asset_class_allocation(asset, clas)) / 100.0f);
-        }
-
+        auto sum = get_class_sum(w.data(), clas, budget::local_day(), true);
         ss2 << budget::money_to_string(sum);
 
         ss2 << "},";
@@ -680,7 +582,7 @@ void budget::portfolio_allocation_page(html_writer& w) {
 void budget::net_worth_currency_page(html_writer& w) {
     std::set<std::string, std::less<>> currencies;
 
-    for (const auto& asset : w.cache.user_assets()) {
+    for (const auto& asset : w.data().user_assets()) {
         currencies.insert(asset.currency);
     }
 
@@ -693,42 +595,19 @@ void budget::net_worth_currency_page(html_writer& w) {
     ss << R"=====(tooltip: {split: true},)=====";
     ss << R"=====(plotOptions: {area: {stacking: 'percent'}},)=====";
 
-    ss << "series: [";
-
-    for (const auto& currency : currencies) {
-        ss << "{ name: '" << currency << "',";
-        ss << "data: [";
-
-        auto date     = budget::asset_start_date(w.cache);
-        auto end_date = budget::local_day();
-
-        while (date <= end_date) {
-            const auto sum = fold_left_auto(w.cache.user_assets() | filter_by_currency(currency) | to_value_conv(w.cache, date))
-                             - fold_left_auto(w.cache.liabilities() | filter_by_currency(currency) | to_value_conv(w.cache, date));
-
-            ss << "[Date.UTC(" << date.year() << "," << date.month().value - 1 << "," << date.day() << ") ," << budget::money_to_string(sum) << "],";
-
-            date += days(1);
-        }
-
-        ss << "]},";
-    }
-
-    ss << "]";
-
-    end_chart(w, ss);
+    end_data_chart(w, ss, "currency_time_graph", "/data/net_worth/currency/");
 
     // 2. Display the value in each currency
 
     for (const auto& currency : currencies) {
         budget::money net_worth;
 
-        for (const auto& asset : w.cache.user_assets()) {
-            net_worth += get_asset_value_conv(asset, currency, w.cache);
+        for (const auto& asset : w.data().user_assets()) {
+            net_worth += get_asset_value_conv(asset, currency, w.data());
         }
 
-        for (auto& liability : w.cache.liabilities()) {
-            net_worth -= get_liability_value_conv(liability, currency, w.cache);
+        for (auto& liability : w.data().liabilities()) {
+            net_worth -= get_liability_value_conv(liability, currency, w.data());
         }
 
         w << p_begin << "Net worth in " << currency << " : " << net_worth << " " << currency << p_end;
@@ -753,10 +632,10 @@ void budget::net_worth_currency_page(html_writer& w) {
         budget::money sum;
 
         // Add the assets in this currency
-        sum += fold_left_auto(w.cache.user_assets() | filter_by_currency(currency) | to_value_conv(w.cache));
+        sum += fold_left_auto(w.data().user_assets() | filter_by_currency(currency) | to_value_conv(w.data()));
 
         // Remove the liabilities in this currency
-        sum -= fold_left_auto(w.cache.liabilities() | filter_by_currency(currency) | to_value_conv(w.cache));
+        sum -= fold_left_auto(w.data().liabilities() | filter_by_currency(currency) | to_value_conv(w.data()));
 
         ss2 << budget::money_to_string(sum);
 
@@ -779,7 +658,7 @@ void budget::portfolio_status_page(html_writer& w) {
 void budget::portfolio_currency_page(html_writer& w) {
     std::set<std::string, std::less<>> currencies;
 
-    for (const auto& asset : w.cache.user_assets()) {
+    for (const auto& asset : w.data().user_assets()) {
         if (asset.portfolio) {
             currencies.insert(asset.currency);
         }
@@ -794,29 +673,7 @@ void budget::portfolio_currency_page(html_writer& w) {
     ss << R"=====(tooltip: {split: true},)=====";
     ss << R"=====(plotOptions: {area: {stacking: 'percent'}},)=====";
 
-    ss << "series: [";
-
-    for (const auto& currency : currencies) {
-        ss << "{ name: '" << currency << "',";
-        ss << "data: [";
-
-        auto date     = budget::asset_start_date(w.cache);
-        auto end_date = budget::local_day();
-
-        while (date <= end_date) {
-            const auto sum = fold_left_auto(w.cache.user_assets() | filter_by_currency(currency) | is_portfolio | to_value_conv(w.cache, date));
-
-            ss << "[Date.UTC(" << date.year() << "," << date.month().value - 1 << "," << date.day() << ") ," << budget::money_to_string(sum) << "],";
-
-            date += days(1);
-        }
-
-        ss << "]},";
-    }
-
-    ss << "]";
-
-    end_chart(w, ss);
+    end_data_chart(w, ss, "portfolio_currency_graph", "/data/portfolio/currency/");
 
     // 2. Display the current currency breakdown
 
@@ -834,7 +691,7 @@ void budget::portfolio_currency_page(html_writer& w) {
         ss2 << "{ name: '" << currency << "',";
         ss2 << "y: ";
 
-        const auto sum = fold_left_auto(w.cache.user_assets() | filter_by_currency(currency) | is_portfolio | to_value_conv(w.cache));
+        const auto sum = fold_left_auto(w.data().user_assets() | filter_by_currency(currency) | is_portfolio | to_value_conv(w.data()));
 
         ss2 << budget::money_to_string(sum);
 
@@ -859,27 +716,7 @@ void budget::portfolio_graph_page(html_writer& w) {
     ss << R"=====(floating:true, align:"right", verticalAlign: "top", style: { fontWeight: "bold", fontSize: "inherit" })=====";
     ss << R"=====(},)=====";
 
-    ss << "series: [";
-
-    ss << "{ name: 'Portfolio',";
-    ss << "data: [";
-
-    auto date     = budget::asset_start_date(w.cache);
-    auto end_date = budget::local_day();
-
-    while (date <= end_date) {
-        const auto sum = fold_left_auto(w.cache.user_assets() | is_portfolio | to_value_conv(w.cache, date));
-
-        ss << "[Date.UTC(" << date.year() << "," << date.month().value - 1 << "," << date.day() << ") ," << budget::money_to_string(sum) << "],";
-
-        date += days(1);
-    }
-
-    ss << "]},";
-
-    ss << "]";
-
-    end_chart(w, ss);
+    end_data_chart(w, ss, "container", "/data/portfolio/daily/");
 }
 
 void rebalance_page_base(html_writer& w, bool nocash) {
@@ -899,19 +736,19 @@ void rebalance_page_base(html_writer& w, bool nocash) {
 
     std::map<size_t, budget::money, std::less<>> asset_amounts;
 
-    for (const auto& asset : w.cache.user_assets() | is_portfolio) {
+    for (const auto& asset : w.data().user_assets() | is_portfolio) {
         if (nocash && asset.is_cash()) {
             continue;
         }
 
-        asset_amounts[asset.id] = get_asset_value(asset, w.cache);
+        asset_amounts[asset.id] = get_asset_value(asset, w.data());
     }
 
     // Compute the colors for each asset that will be displayed
 
     std::map<size_t, size_t, std::less<>> colors;
 
-    for (const auto& asset : w.cache.user_assets() | is_portfolio) {
+    for (const auto& asset : w.data().user_assets() | is_portfolio) {
         if (nocash && asset.is_cash()) {
             continue;
         }
@@ -924,7 +761,7 @@ void rebalance_page_base(html_writer& w, bool nocash) {
 
     // Compute the colors for the first graph
 
-    std::stringstream current_ss;
+    budget::output_buffer current_ss;
 
     current_ss
             << R"=====(var current_base_colors = ["#7cb5ec", "#434348", "#90ed7d", "#f7a35c", "#8085e9", "#f15c80", "#e4d354", "#2b908f", "#f45b5b", "#91e8e1", "red", "blue", "green"];)=====";
@@ -972,7 +809,7 @@ void rebalance_page_base(html_writer& w, bool nocash) {
 
     ss << "]";
 
-    current_ss << ss.str();
+    current_ss << ss.view();
 
     end_chart(w, current_ss);
 
@@ -982,7 +819,7 @@ void rebalance_page_base(html_writer& w, bool nocash) {
 
     // Compute the colors for the second graph
 
-    std::stringstream desired_ss;
+    budget::output_buffer desired_ss;
 
     desired_ss
             << R"=====(var desired_base_colors = ["#7cb5ec", "#434348", "#90ed7d", "#f7a35c", "#8085e9", "#f15c80", "#e4d354", "#2b908f", "#f45b5b", "#91e8e1", "red", "blue", "green"];)=====";
@@ -990,7 +827,7 @@ void rebalance_page_base(html_writer& w, bool nocash) {
     desired_ss << "var desired_pie_colors = (function () {";
     desired_ss << "var colors = [];";
 
-    for (const auto& asset : w.cache.user_assets()) {
+    for (const auto& asset : w.data().user_assets()) {
         if (asset.portfolio && asset.portfolio_alloc) {
             desired_ss << "colors.push(desired_base_colors[" << colors[asset.id] << "]);";
         }
@@ -1012,7 +849,7 @@ void rebalance_page_base(html_writer& w, bool nocash) {
     ss2 << "colors: desired_pie_colors,";
     ss2 << "data: [";
 
-    for (const auto& asset : w.cache.user_assets()) {
+    for (const auto& asset : w.data().user_assets()) {
         if (asset.portfolio && asset.portfolio_alloc) {
             ss2 << "{ name: '" << asset.name << "',";
             ss2 << "y: ";
@@ -1025,7 +862,7 @@ void rebalance_page_base(html_writer& w, bool nocash) {
 
     ss2 << "]";
 
-    desired_ss << ss2.str();
+    desired_ss << ss2.view();
 
     end_chart(w, desired_ss);
 
@@ -7,8 +7,10 @@
 
 #include "pages/objectives_pages.hpp"
 #include "pages/html_writer.hpp"
+#include "pages/trace.hpp"
 #include "http.hpp"
 #include "config.hpp"
+#include "lazy_data.hpp"
 
 using namespace budget;
 
@@ -116,8 +118,12 @@ void add_objective_source_picker(budget::writer& w, std::string_view default_val
 } // namespace
 
 void budget::objectives_card(budget::html_writer& w) {
+    require_objectives();
+
+    BUDGET_TRACE_SPAN("objectives_card");
+
     // if the user does not use objectives, this card does not make sense
-    if (w.cache.objectives().empty()) {
+    if (w.data().objectives().empty()) {
         return;
     }
 
@@ -127,16 +133,16 @@ void budget::objectives_card(budget::html_writer& w) {
     const auto y = today.year();
 
     // Compute the year/month status
-    auto year_status  = budget::compute_year_status(w.cache);
-    auto month_status = budget::compute_month_status(w.cache, y, m);
+    auto year_status  = budget::compute_year_status(w.data());
+    auto month_status = budget::compute_month_status(w.data(), y, m);
 
     w << R"=====(<div class="card">)=====";
     w << R"=====(<div class="card-header card-header-primary">Goals</div>)=====";
 
     w << R"=====(<div class="row card-body">)=====";
 
-    for (size_t i = 0; i < w.cache.objectives().size(); ++i) {
-        auto& objective = w.cache.objectives()[i];
+    for (size_t i = 0; i < w.data().objectives().size(); ++i) {
+        auto& objective = w.data().objectives()[i];
 
         w << R"=====(<div class="col-lg-2 col-md-3 col-sm-4 col-xs-6">)=====";
 
@@ -199,16 +205,22 @@ void budget::objectives_card(budget::html_writer& w) {
 }
 
 void budget::list_objectives_page(html_writer& w) {
+    require_objectives();
+
     budget::list_objectives(w);
 
     make_tables_sortable(w);
 }
 
 void budget::status_objectives_page(html_writer& w) {
+    require_objectives();
+
     budget::status_objectives(w);
 }
 
 void budget::add_objectives_page(html_writer& w) {
+    require_objectives();
+
     w << title_begin << "New objective" << title_end;
 
     form_begin(w, "/api/objectives/add/", "/objectives/add/");
@@ -223,6 +235,8 @@ void budget::add_objectives_page(html_writer& w) {
 }
 
 void budget::edit_objectives_page(html_writer& w, const httplib::Request& req) {
+    require_objectives();
+
     if (!validate_parameters(w, req, {"input_id", "back_page"})) {
         return;
     }
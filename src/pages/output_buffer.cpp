@@ -0,0 +1,48 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <vector>
+
+#include "pages/output_buffer.hpp"
+
+using namespace budget;
+
+namespace {
+
+// Only keep a few buffers per thread and do not hoard very large ones. The small
+// ones are not worth keeping, this also drops the moved-from buffers, which keep
+// the capacity of the small string optimization.
+constexpr size_t max_pooled_buffers  = 8;
+constexpr size_t min_pooled_capacity = 4096;
+constexpr size_t max_pooled_capacity = 4 * 1024 * 1024;
+
+thread_local std::vector<std::string> pool;
+
+} // end of anonymous namespace
+
+std::string budget::acquire_buffer(size_t capacity) {
+    std::string buffer;
+
+    if (!pool.empty()) {
+        buffer = std::move(pool.back());
+        pool.pop_back();
+    }
+
+    buffer.clear();
+    buffer.reserve(capacity);
+
+    return buffer;
+}
+
+void budget::release_buffer(std::string&& buffer) {
+    if (buffer.capacity() < min_pooled_capacity || buffer.capacity() > max_pooled_capacity || pool.size() >= max_pooled_buffers) {
+        return;
+    }
+
+    buffer.clear();
+    pool.push_back(std::move(buffer));
+}
@@ -118,8 +118,8 @@ void budget::overview_year_page(html_writer& w, const httplib::Request& req) {
         ss << "{ name: '" << year << " Expenses',";
         ss << "data: [";
 
-        for (budget::month month = start_month(w.cache, year); month < last; ++month) {
-            auto sum = fold_left_auto(all_expenses_month(w.cache, year, month) | to_amount);
+        for (budget::month month = start_month(w.data(), year); month < last; ++month) {
+            auto sum = fold_left_auto(all_expenses_month(w.data(), year, month) | to_amount);
 
             const std::string date = std::format("Date.UTC({},{},1)", year.value, month.value - 1);
             ss << "[" << date << "," << budget::money_to_string(sum) << "],";
@@ -127,12 +127,12 @@ void budget::overview_year_page(html_writer& w, const httplib::Request& req) {
 
         ss << "]},";
 
-        if (year - date_type(1) >= start_year(w.cache)) {
+        if (year - date_type(1) >= start_year(w.data())) {
             ss << "{ name: '" << year - date_type(1) << " Expenses',";
             ss << "data: [";
 
-            for (budget::month month = start_month(w.cache, year - date_type(1)); month.is_valid(); ++month) {
-                auto sum = fold_left_auto(all_expenses_month(w.cache, year - date_type(1), month) | to_amount);
+            for (budget::month month = start_month(w.data(), year - date_type(1)); month.is_valid(); ++month) {
+                auto sum = fold_left_auto(all_expenses_month(w.data(), year - date_type(1), month) | to_amount);
 
                 const std::string date = std::format("Date.UTC({},{},1)", year.value, month.value - date_type(1));
                 ss << "[" << date << "," << budget::money_to_string(sum) << "],";
@@ -160,8 +160,8 @@ void budget::overview_year_page(html_writer& w, const httplib::Request& req) {
         ss << "{ name: '" << year << " Expenses',";
         ss << "data: [";
 
-        for (budget::month month = start_month(w.cache, year); month < last; ++month) {
-            auto sum = get_base_income(w.cache, budget::date(year, month, 2)) + fold_left_auto(all_earnings_month(w.cache, year, month) | to_amount);
+        for (budget::month month = start_month(w.data(), year); month < last; ++month) {
+            auto sum = get_base_income(w.data(), budget::date(year, month, 2)) + fold_left_auto(all_earnings_month(w.data(), year, month) | to_amount);
 
             const std::string date = std::format("Date.UTC({},{},1)", year.value, month.value - 1);
             ss << "[" << date << "," << budget::money_to_string(sum) << "],";
@@ -169,13 +169,13 @@ void budget::overview_year_page(html_writer& w, const httplib::Request& req) {
 
         ss << "]},";
 
-        if (year - date_type(1) >= start_year(w.cache)) {
+        if (year - date_type(1) >= start_year(w.data())) {
             ss << "{ name: '" << year - date_type(1) << " Expenses',";
             ss << "data: [";
 
-            for (budget::month month = start_month(w.cache, year - date_type(1)); month.is_valid(); ++month) {
+            for (budget::month month = start_month(w.data(), year - date_type(1)); month.is_valid(); ++month) {
                 auto sum =
-                        get_base_income(w.cache, budget::date(year - date_type(1), month, 2)) + fold_left_auto(all_earnings_month(w.cache, year - date_type(1), month) | to_amount);
+                        get_base_income(w.data(), budget::date(year - date_type(1), month, 2)) + fold_left_auto(all_earnings_month(w.data(), year - date_type(1), month) | to_amount);
 
                 const std::string date = std::format("Date.UTC({},{},1)", year.value, month.value - date_type(1));
                 ss << "[" << date << "," << budget::money_to_string(sum) << "],";
@@ -208,14 +208,14 @@ void budget::time_graph_savings_rate_page(html_writer& w) {
     std::vector<double>       serie;
     std::vector<std::string> dates;
 
-    auto sy = start_year(w.cache);
+    auto sy = start_year(w.data());
 
     for (budget::year year = sy; year <= budget::local_day().year(); ++year) {
-        const auto sm   = start_month(w.cache, year);
+        const auto sm   = start_month(w.data(), year);
         const auto last = last_month(year);
 
         for (budget::month month = sm; month < last; ++month) {
-            auto status = budget::compute_month_status(w.cache, year, month);
+            auto status = budget::compute_month_status(w.data(), year, month);
 
             auto savings      = status.income - status.expenses;
             double savings_rate = 0.0;
@@ -263,8 +263,6 @@ void budget::time_graph_savings_rate_page(html_writer& w) {
 }
 
 void budget::time_graph_tax_rate_page(html_writer& w) {
-    std::stringstream const content_stream;
-
     if (has_taxes_account()) {
         auto ss = start_time_chart(w, "Tax rate over time", "line", "tax_time_graph", "");
 
@@ -279,16 +277,16 @@ void budget::time_graph_tax_rate_page(html_writer& w) {
         std::vector<double>       serie;
         std::vector<std::string> dates;
 
-        auto sy = start_year(w.cache);
+        auto sy = start_year(w.data());
 
         double max = 1.0;
 
         for (budget::year year = sy; year <= budget::local_day().year(); ++year) {
-            const auto sm   = start_month(w.cache, year);
+            const auto sm   = start_month(w.data(), year);
             const auto last = last_month(year);
 
             for (budget::month month = sm; month < last; ++month) {
-                auto status = budget::compute_month_status(w.cache, year, month);
+                auto status = budget::compute_month_status(w.data(), year, month);
 
                 double tax_rate = status.taxes / status.income;
 
@@ -347,8 +345,8 @@ void budget::time_graph_tax_rate_page(html_writer& w) {
 
 namespace {
 
-void display_side_month_overview(budget::month month, budget::year year, budget::writer& writer) {
-    auto accounts = all_accounts(writer.cache, year, month);
+void display_side_month_overview(budget::month month, budget::year year, budget::html_writer& writer) {
+    auto accounts = all_accounts(writer.data(), year, month);
 
     writer << title_begin << "Side Hustle Overview of " << month << " " << year << budget::year_month_selector{"side_hustle/overview", year, month}
            << title_end;
@@ -366,13 +364,13 @@ void display_side_month_overview(budget::month month, budget::year year, budget:
     std::vector<budget::expense> side_expenses;
     std::vector<budget::earning> side_earnings;
 
-    for (const auto& expense : writer.cache.expenses() | persistent | filter_by_account_name(side_category)) {
+    for (const auto& expense : writer.data().expenses() | persistent | filter_by_account_name(side_category)) {
         if (side_prefix.empty() || expense.name.find(side_prefix) == 0) {
             side_expenses.push_back(expense);
         }
     }
 
-    for (const auto& earning : writer.cache.earnings() | filter_by_account_name(side_category)) {
+    for (const auto& earning : writer.data().earnings() | filter_by_account_name(side_category)) {
         if (side_prefix.empty() || earning.name.find(side_prefix) == 0) {
             side_earnings.push_back(earning);
         }
@@ -0,0 +1,259 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "pages/page_cache.hpp"
+#include "pages/compression.hpp"
+#include "config.hpp"
+#include "date.hpp"
+#include "http.hpp"
+#include "utils.hpp"
+
+using namespace budget;
+
+namespace {
+
+// The generation starts from the startup time so that it is never reused after
+// a restart, even if the data files were modified while the server was down
+std::atomic<size_t> current_generation =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+struct page_entry {
+    std::list<std::string>::iterator   lru;
+    size_t                             generation;
+    std::shared_ptr<const cached_page> page;
+};
+
+std::mutex                                  cache_lock;
+std::list<std::string>                      lru_keys; // Most recently used first
+std::unordered_map<std::string, page_entry> entries;
+size_t                                      cached_bytes = 0;
+
+std::atomic<size_t> hits   = 0;
+std::atomic<size_t> misses = 0;
+
+// The maximum size of the cache, in bytes (configured in MiB)
+size_t page_cache_capacity() {
+    static const size_t capacity = to_number<size_t>(config_value("server_page_cache_size", "32")) * 1024 * 1024;
+    return capacity;
+}
+
+// Note: cache_lock must be held
+void erase_entry(std::unordered_map<std::string, page_entry>::iterator it) {
+    cached_bytes -= it->second.page->content.size();
+    lru_keys.erase(it->second.lru);
+    entries.erase(it);
+}
+
+} // end of anonymous namespace
+
+size_t budget::data_generation() {
+    return current_generation.load();
+}
+
+void budget::bump_data_generation() {
+    ++current_generation;
+}
+
+std::string budget::make_etag(std::string_view key, size_t generation) {
+    return std::format("\"{:x}-{:x}\"", generation, std::hash<std::string_view>{}(key));
+}
+
+bool budget::etag_matches(const httplib::Request& req, std::string_view etag) {
+    if (!req.has_header("If-None-Match")) {
+        return false;
+    }
+
+    auto header = req.get_header_value("If-None-Match");
+
+    if (header == "*") {
+        return true;
+    }
+
+    // The header is a list of (possibly weak) entity tags
+    for (auto candidate : budget::splitv(header, ',')) {
+        while (!candidate.empty() && candidate.front() == ' ') {
+            candidate.remove_prefix(1);
+        }
+
+        while (!candidate.empty() && candidate.back() == ' ') {
+            candidate.remove_suffix(1);
+        }
+
+        if (candidate.starts_with("W/")) {
+            candidate.remove_prefix(2);
+        }
+
+        if (candidate == etag) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool budget::is_page_cacheable(const httplib::Request& req) {
+    // The messages are only displayed once, after an action, and the traces are for one render
+    return req.method == "GET" && !req.has_param("message") && !req.has_param("trace");
+}
+
+std::string budget::page_cache_key(const httplib::Request& req) {
+    std::string key;
+
+    // Most pages depend on the current day
+    key += budget::to_string(budget::local_day());
+    key += '\n';
+
+    if (is_secure()) {
+        key += get_web_user();
+    }
+
+    key += '\n';
+    key += req.path;
+
+    // The parameters are sorted by name
+    for (const auto& [name, value] : req.params) {
+        key += '\n';
+        key += name;
+        key += '=';
+        key += value;
+    }
+
+    return key;
+}
+
+std::shared_ptr<const cached_page> budget::page_cache_get(const std::string& key) {
+    const std::lock_guard guard(cache_lock);
+
+    auto it = entries.find(key);
+
+    if (it == entries.end()) {
+        ++misses;
+        return nullptr;
+    }
+
+    // The page was rendered before the last change of data
+    if (it->second.generation != data_generation()) {
+        erase_entry(it);
+        ++misses;
+        return nullptr;
+    }
+
+    lru_keys.splice(lru_keys.begin(), lru_keys, it->second.lru);
+    ++hits;
+
+    return it->second.page;
+}
+
+void budget::page_cache_put(const std::string& key, size_t generation, cached_page page) {
+    // Do not cache a page that was rendered while the data changed
+    if (generation != data_generation() || page.content.size() > page_cache_capacity()) {
+        return;
+    }
+
+    const std::lock_guard guard(cache_lock);
+
+    if (auto it = entries.find(key); it != entries.end()) {
+        erase_entry(it);
+    }
+
+    // Evict the least recently used pages until the new one fits
+
+    while (!lru_keys.empty() && cached_bytes + page.content.size() > page_cache_capacity()) {
+        erase_entry(entries.find(lru_keys.back()));
+    }
+
+    cached_bytes += page.content.size();
+    lru_keys.push_front(key);
+    entries[key] = {lru_keys.begin(), generation, std::make_shared<const cached_page>(std::move(page))};
+}
+
+page_cache_stats budget::get_page_cache_stats() {
+    const std::lock_guard guard(cache_lock);
+
+    return {hits.load(), misses.load(), entries.size(), cached_bytes};
+}
+
+std::vector<std::pair<std::string, std::shared_ptr<const cached_page>>> budget::page_cache_entries() {
+    const std::lock_guard guard(cache_lock);
+
+    const auto generation = data_generation();
+
+    std::vector<std::pair<std::string, std::shared_ptr<const cached_page>>> pages;
+
+    for (const auto& key : lru_keys) {
+        if (const auto& entry = entries.at(key); entry.generation == generation) {
+            pages.emplace_back(key, entry.page);
+        }
+    }
+
+    return pages;
+}
+
+cached_response budget::make_cached_response(const httplib::Request& req) {
+    cached_response cached;
+
+    cached.generation = data_generation();
+    cached.key        = page_cache_key(req);
+
+    if (accepts_gzip(req)) {
+        cached.key += "\ngzip";
+    }
+
+    cached.etag = make_etag(cached.key, cached.generation);
+
+    return cached;
+}
+
+void budget::set_validators(httplib::Response& res, const cached_response& cached) {
+    // The responses are private and must always be revalidated
+    res.set_header("ETag", cached.etag);
+    res.set_header("Cache-Control", "private, no-cache");
+    vary_on_encoding(res);
+}
+
+bool budget::serve_not_modified(const httplib::Request& req, httplib::Response& res, const cached_response& cached) {
+    if (!etag_matches(req, cached.etag)) {
+        return false;
+    }
+
+    set_validators(res, cached);
+    res.status = 304;
+
+    return true;
+}
+
+bool budget::serve_cached(const httplib::Request& req, httplib::Response& res, const cached_response& cached, const char* content_type) {
+    if (serve_not_modified(req, res, cached)) {
+        return true;
+    }
+
+    auto page = page_cache_get(cached.key);
+
+    if (!page) {
+        return false;
+    }
+
+    set_validators(res, cached);
+    res.set_content(page->content, content_type);
+
+    if (!page->encoding.empty()) {
+        res.set_header("Content-Encoding", page->encoding);
+    }
+
+    return true;
+}
+
+void budget::cache_response(const httplib::Response& res, const cached_response& cached) {
+    page_cache_put(cached.key, cached.generation, {res.body, res.get_header_value("Content-Encoding")});
+}
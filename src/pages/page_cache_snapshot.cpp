@@ -0,0 +1,238 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include "pages/page_cache.hpp"
+#include "config.hpp"
+#include "data_lock.hpp"
+#include "date.hpp"
+#include "logging.hpp"
+#include "version.hpp"
+
+using namespace budget;
+
+namespace {
+
+// Must be incremented whenever the layout of the snapshot changes
+constexpr uint32_t snapshot_format = 1;
+constexpr char     snapshot_magic[4] = {'B', 'W', 'P', 'C'};
+
+constexpr std::string_view snapshot_name = "page_cache.snapshot";
+
+// Protects against corrupted sizes, the page cache itself is much smaller
+constexpr uint64_t max_string_size = uint64_t(1) << 30;
+
+bool snapshot_enabled() {
+    static const bool enabled = config_value("server_page_cache_snapshot", "true") == "true";
+    return enabled;
+}
+
+std::filesystem::path snapshot_path() {
+    return std::filesystem::path(budget_folder()) / snapshot_name;
+}
+
+void write_u64(std::ostream& out, uint64_t value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void write_string(std::ostream& out, std::string_view value) {
+    write_u64(out, value.size());
+    out.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+bool read_u64(std::istream& in, uint64_t& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+bool read_string(std::istream& in, std::string& value) {
+    uint64_t size = 0;
+    if (!read_u64(in, size) || size > max_string_size) {
+        return false;
+    }
+
+    value.resize(size);
+    return static_cast<bool>(in.read(value.data(), static_cast<std::streamsize>(size)));
+}
+
+// Describe one file by its name, size and modification time
+void fingerprint_file(std::string& fingerprint, const std::filesystem::path& path) {
+    std::error_code error;
+
+    const auto size  = std::filesystem::file_size(path, error);
+    const auto mtime = std::filesystem::last_write_time(path, error);
+
+    if (error) {
+        return;
+    }
+
+    fingerprint += path.string();
+    fingerprint += std::format(":{}:{}\n", size, mtime.time_since_epoch().count());
+}
+
+// Everything the pages are rendered from: the server itself, the configuration and the data files
+std::string data_fingerprint() {
+    std::string fingerprint = std::format("{}\n", get_version());
+
+    // The contents are not hashed, that would read all the data at each startup
+    std::error_code error;
+    if (auto executable = std::filesystem::read_symlink("/proc/self/exe", error); !error) {
+        fingerprint_file(fingerprint, executable);
+    }
+
+    if (const char* home = std::getenv("HOME")) {
+        fingerprint_file(fingerprint, std::filesystem::path(home) / ".budgetrc");
+    }
+
+    std::vector<std::filesystem::path> files;
+
+    for (const auto& entry : std::filesystem::directory_iterator(budget_folder(), error)) {
+        // The snapshot (and its temporary) are not part of the data
+        if (entry.is_regular_file(error) && !entry.path().filename().string().starts_with(snapshot_name)) {
+            files.push_back(entry.path());
+        }
+    }
+
+    std::ranges::sort(files);
+
+    for (const auto& file : files) {
+        fingerprint_file(fingerprint, file);
+    }
+
+    return fingerprint;
+}
+
+} // end of anonymous namespace
+
+void budget::save_page_cache() {
+    if (!snapshot_enabled()) {
+        return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::pair<std::string, std::shared_ptr<const cached_page>>> pages;
+    std::string                                                             fingerprint;
+
+    // The pages and the data files must not change in between
+    {
+        auto data_lock = read_data();
+
+        pages       = page_cache_entries();
+        fingerprint = data_fingerprint();
+    }
+
+    // Written aside and renamed, so that a crash never leaves a partial snapshot
+    const auto path      = snapshot_path();
+    auto       temporary = path;
+    temporary += ".tmp";
+
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+
+        out.write(snapshot_magic, sizeof(snapshot_magic));
+        write_u64(out, snapshot_format);
+        write_string(out, fingerprint);
+        write_u64(out, pages.size());
+
+        for (const auto& [key, page] : pages) {
+            write_string(out, key);
+            write_string(out, page->encoding);
+            write_string(out, page->content);
+        }
+
+        if (!out) {
+            LOG_F(ERROR, "Could not write the page cache snapshot {}", temporary.string());
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+
+    if (error) {
+        LOG_F(ERROR, "Could not save the page cache snapshot: {}", error.message());
+        return;
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    LOG_F(INFO, "Saved {} pages in the page cache snapshot in {}ms", pages.size(), elapsed.count());
+}
+
+void budget::load_page_cache() {
+    if (!snapshot_enabled()) {
+        return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::ifstream in(snapshot_path(), std::ios::binary);
+
+    if (!in) {
+        return;
+    }
+
+    char        magic[sizeof(snapshot_magic)] = {};
+    uint64_t    format                        = 0;
+    std::string fingerprint;
+
+    in.read(magic, sizeof(magic));
+
+    if (!in || !std::equal(std::begin(magic), std::end(magic), std::begin(snapshot_magic)) || !read_u64(in, format) || format != snapshot_format) {
+        LOG_F(INFO, "Ignored the page cache snapshot with an unknown format");
+        return;
+    }
+
+    if (!read_string(in, fingerprint) || fingerprint != data_fingerprint()) {
+        LOG_F(INFO, "Ignored the outdated page cache snapshot");
+        return;
+    }
+
+    uint64_t count = 0;
+    if (!read_u64(in, count)) {
+        return;
+    }
+
+    // The pages of the previous days are never used again
+    const auto today = budget::to_string(budget::local_day()) + '\n';
+
+    std::vector<std::pair<std::string, cached_page>> pages;
+
+    for (uint64_t i = 0; i < count; ++i) {
+        std::string key;
+        cached_page page;
+
+        if (!read_string(in, key) || !read_string(in, page.encoding) || !read_string(in, page.content)) {
+            LOG_F(ERROR, "Ignored the truncated page cache snapshot");
+            return;
+        }
+
+        if (key.starts_with(today)) {
+            pages.emplace_back(std::move(key), std::move(page));
+        }
+    }
+
+    // The data did not change, the pages are valid for the current generation.
+    // The least recently used are inserted first to keep the order.
+    const auto generation = data_generation();
+
+    for (auto& [key, page] : pages | std::views::reverse) {
+        page_cache_put(key, generation, std::move(page));
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    LOG_F(INFO, "Restored {} pages from the page cache snapshot in {}ms", pages.size(), elapsed.count());
+}
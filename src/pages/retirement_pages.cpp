@@ -76,45 +76,5 @@ void budget::retirement_fi_ratio_over_time(html_writer& w) {
     ss << R"=====(yAxis: { min: 0, title: { text: 'FI Ratio' }},)=====";
     ss << R"=====(legend: { enabled: false },)=====";
 
-    ss << "series: [";
-
-    ss << "{ name: 'FI Ratio (Current Expenses)',";
-    ss << "data: [";
-
-    {
-        auto date     = budget::asset_start_date(w.cache);
-        auto end_date = budget::local_day();
-
-        while (date <= end_date) {
-            const auto ratio = budget::fi_ratio(date, w.cache);
-
-            ss << std::format("[Date.UTC({},{},{}), {}],", date.year().value, date.month().value - 1, date.day().value, 100 * ratio);
-
-            date += days(1);
-        }
-
-        ss << "]},";
-    }
-
-    if (auto fixed_expenses = budget::get_fi_expenses(); fixed_expenses) {
-        ss << "{ name: 'FI Ratio (" << fixed_expenses.dollars() << ' ' << get_default_currency() << " yearly expenses)',";
-        ss << "data: [";
-
-        auto date     = budget::asset_start_date(w.cache);
-        auto end_date = budget::local_day();
-
-        while (date <= end_date) {
-            const auto ratio = budget::fixed_fi_ratio(date, w.cache, fixed_expenses);
-
-            ss << std::format("[Date.UTC({},{},{}), {}],", date.year().value, date.month().value - 1, date.day().value, 100 * ratio);
-
-            date += days(1);
-        }
-
-        ss << "]},";
-    }
-
-    ss << "]";
-
-    end_chart(w, ss);
+    end_data_chart(w, ss, "fi_time_graph", "/data/retirement/fi_ratio/");
 }
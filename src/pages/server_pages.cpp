@@ -7,6 +7,8 @@
 
 #include <openssl/md5.h>
 
+#include <atomic>
+#include <memory>
 #include <numeric>
 #include <set>
 #include <utility>
@@ -15,9 +17,14 @@
 #include "config.hpp"
 #include "cpp_utils/string.hpp"
 #include "currency.hpp"
+#include "data_lock.hpp"
 #include "logging.hpp"
 #include "overview.hpp"
+#include "pages/compression.hpp"
+#include "pages/data_pages.hpp"
 #include "pages/html_writer.hpp"
+#include "pages/page_cache.hpp"
+#include "pages/trace.hpp"
 #include "summary.hpp"
 #include "version.hpp"
 
@@ -52,8 +59,9 @@ namespace {
 
 constexpr const char new_line = '\n';
 
-std::string header(std::string_view title, bool menu = true) {
-    std::stringstream stream;
+// The static part of the header, before the title
+std::string head_fragment() {
+    budget::output_buffer stream;
 
     // The header
 
@@ -177,11 +185,12 @@ std::string header(std::string_view title, bool menu = true) {
             </style>
     )=====";
 
-    if (title.empty()) {
-        stream << "<title>budgetwarrior</title>";
-    } else {
-        stream << "<title>budgetwarrior - " << title << "</title>";
-    }
+    return std::move(stream).str();
+}
+
+// The static part of the header, after the title, including the navigation
+std::string nav_fragment(bool menu) {
+    budget::output_buffer stream;
 
     stream << new_line;
 
@@ -422,7 +431,46 @@ std::string header(std::string_view title, bool menu = true) {
 
     stream << R"=====(<main class="container-fluid">)=====" << new_line;
 
-    return stream.str();
+    return std::move(stream).str();
+}
+
+struct header_fragments {
+    precompressed_fragment head;
+    precompressed_fragment nav_menu;
+    precompressed_fragment nav_no_menu;
+};
+
+// The fragments only depend on the configuration, they are shared by all the pages
+std::atomic<std::shared_ptr<const header_fragments>> current_header_fragments;
+
+void header(budget::output_buffer& stream, std::string_view title, bool menu = true) {
+    auto fragments = current_header_fragments.load();
+
+    stream << fragments->head.content;
+
+    if (title.empty()) {
+        stream << "<title>budgetwarrior</title>";
+    } else {
+        stream << "<title>budgetwarrior - " << title << "</title>";
+    }
+
+    stream << (menu ? fragments->nav_menu.content : fragments->nav_no_menu.content);
+}
+
+// Compress the page if worth it, the header fragments were compressed only once
+void compress_page(const httplib::Request& req, httplib::Response& res) {
+    vary_on_encoding(res);
+
+    if (!should_compress(req, res.body.size())) {
+        return;
+    }
+
+    auto fragments = current_header_fragments.load();
+
+    const precompressed_fragment* pieces[] = {&fragments->head, &fragments->nav_menu};
+
+    res.body = gzip_compress(res.body, pieces);
+    res.set_header("Content-Encoding", "gzip");
 }
 
 void display_message(budget::writer& w, const httplib::Request& req) {
@@ -440,23 +488,49 @@ void display_message(budget::writer& w, const httplib::Request& req) {
     }
 }
 
-void replace_all(std::string& source, std::string_view from, std::string_view to) {
-    size_t current_pos = 0;
-
-    while ((current_pos = source.find(from, current_pos)) != std::string::npos) {
-        source.replace(current_pos, from.length(), to);
-        current_pos += to.length();
-    }
-}
+// Replace the placeholders of the page in a single pass
+std::string filter_html(std::string_view html, const httplib::Request& req) {
+    constexpr std::string_view this_page_placeholder = "__budget_this_page__";
+    constexpr std::string_view currency_placeholder  = "__currency__";
 
-void filter_html(std::string& html, const httplib::Request& req) {
+    std::string this_page;
     if (req.has_param("input_name")) {
-        replace_all(html, "__budget_this_page__", html_base64_encode(req.path + "?input_name=" + req.get_param_value("input_name")));
+        this_page = html_base64_encode(req.path + "?input_name=" + req.get_param_value("input_name"));
     } else {
-        replace_all(html, "__budget_this_page__", html_base64_encode(req.path));
+        this_page = html_base64_encode(req.path);
     }
 
-    replace_all(html, "__currency__", get_default_currency());
+    const auto& currency = get_default_currency();
+
+    std::string result;
+    result.reserve(html.size() + html.size() / 16);
+
+    size_t copied  = 0;
+    size_t current = html.find("__");
+
+    while (current != std::string_view::npos) {
+        const auto rest = html.substr(current);
+
+        if (rest.starts_with(this_page_placeholder)) {
+            result.append(html.substr(copied, current - copied));
+            result.append(this_page);
+            current += this_page_placeholder.size();
+            copied = current;
+        } else if (rest.starts_with(currency_placeholder)) {
+            result.append(html.substr(copied, current - copied));
+            result.append(currency);
+            current += currency_placeholder.size();
+            copied = current;
+        } else {
+            ++current;
+        }
+
+        current = html.find("__", current);
+    }
+
+    result.append(html.substr(copied));
+
+    return result;
 }
 
 // Note: This must be synchronized with page_end
@@ -479,19 +553,64 @@ void call_render_function(html_writer& w, const httplib::Request& req, void (*re
 
 template <typename T>
 auto render_wrapper(const char* title, T render_function) {
-    return [title, render_function](const httplib::Request& req, httplib::Response& res) {
-        std::stringstream content_stream;
+    // The output buffer of the route is sized from the previous renders
+    auto estimate = std::make_shared<size_estimate>();
+
+    return [title, render_function, estimate](const httplib::Request& req, httplib::Response& res) {
+        const bool cacheable = is_page_cacheable(req);
+
+        cached_response cached;
+
+        if (cacheable) {
+            cached = make_cached_response(req);
+
+            if (!authenticate(req, res) || serve_cached(req, res, cached, "text/html")) {
+                return;
+            }
+        }
+
+        // The rendering and the error pages may read the data
+        auto data_lock = read_data();
+
+        budget::output_buffer content_stream(estimate->get() + estimate->get() / 8);
 
         budget::html_writer w(content_stream);
 
+#ifdef BUDGET_TRACE
+        budget::trace_recorder recorder(req.has_param("trace"));
+#endif
+
         try {
-            if (!page_start(req, res, content_stream, title)) {
-                return;
+            {
+                BUDGET_TRACE_SPAN("page_start");
+
+                if (!page_start(req, res, content_stream, title)) {
+                    return;
+                }
             }
 
-            call_render_function(w, req, render_function);
+            {
+                BUDGET_TRACE_SPAN("render");
+                call_render_function(w, req, render_function);
+            }
 
-            page_end(w, req, res);
+            {
+                BUDGET_TRACE_SPAN("page_end");
+                page_end(w, req, res);
+            }
+
+            estimate->update(res.body.size());
+
+#ifdef BUDGET_TRACE
+            recorder.write(req, res);
+#endif
+
+            compress_page(req, res);
+
+            if (cacheable) {
+                set_validators(res, cached);
+                cache_response(res, cached);
+            }
         } catch (const budget_exception& e) {
             display_error_message(w, "Exception occured: {}", e.message());
             LOG_F(ERROR, "budget_exception occured in render({}): {}", req.path, e.message());
@@ -510,7 +629,16 @@ auto render_wrapper(const char* title, T render_function) {
 
 } // end of anonymous namespace
 
+void budget::rebuild_page_fragments() {
+    current_header_fragments.store(std::make_shared<const header_fragments>(
+            precompress(head_fragment()), precompress(nav_fragment(true)), precompress(nav_fragment(false))));
+}
+
 void budget::load_pages(httplib::Server& server) {
+    rebuild_page_fragments();
+
+    load_data_pages(server);
+
     // Declare all the pages
     server.Get("/", render_wrapper("", &index_page));
 
@@ -645,13 +773,12 @@ void budget::load_pages(httplib::Server& server) {
     // Handle error
 
     server.set_error_handler([](const auto& req, auto& res) {
-        std::stringstream content_stream;
-        content_stream.imbue(std::locale("C"));
+        budget::output_buffer content_stream;
 
         if (res.status == 401 || res.status == 403) {
-            content_stream << header("", false);
+            header(content_stream, "", false);
         } else {
-            content_stream << header("", true);
+            header(content_stream, "", true);
         }
 
         content_stream << "<p>Error Status: <span class='text-danger'>";
@@ -664,7 +791,7 @@ void budget::load_pages(httplib::Server& server) {
 
         content_stream << footer();
 
-        res.set_content(content_stream.str(), "text/html");
+        res.set_content(std::move(content_stream).str(), "text/html");
     });
 }
 
@@ -819,14 +946,12 @@ bool budget::authenticate(const httplib::Request& req, httplib::Response& res) {
     return true;
 }
 
-bool budget::page_start(const httplib::Request& req, httplib::Response& res, std::stringstream& content_stream, std::string_view title) {
-    content_stream.imbue(std::locale("C"));
-
+bool budget::page_start(const httplib::Request& req, httplib::Response& res, budget::output_buffer& content_stream, std::string_view title) {
     if (!authenticate(req, res)) {
         return false;
     }
 
-    content_stream << header(title);
+    header(content_stream, title);
 
     budget::html_writer w(content_stream);
     display_message(w, req);
@@ -849,11 +974,8 @@ void budget::page_end(budget::html_writer& w, const httplib::Request& req, httpl
     w.load_deferred_scripts();
     w << "</body></html>";
 
-    auto result = w.os.str();
-
-    filter_html(result, req);
-
-    res.set_content(result, "text/html");
+    // The buffer of the writer goes back to the pool, the filtered page is moved to the response
+    res.set_content(filter_html(w.os.view(), req), "text/html");
 }
 
 void budget::make_tables_sortable(budget::html_writer& w) {
@@ -1067,7 +1189,7 @@ void budget::add_date_picker(budget::writer& w, std::string_view default_value,
     }
 }
 
-std::stringstream budget::start_chart_base(budget::html_writer& w, std::string_view chart_type, std::string_view id, std::string_view style) {
+budget::output_buffer budget::start_chart_base(budget::html_writer& w, std::string_view chart_type, std::string_view id, std::string_view style) {
     w.use_module("highcharts");
 
     w << R"=====(<div id=")=====";
@@ -1081,8 +1203,7 @@ std::stringstream budget::start_chart_base(budget::html_writer& w, std::string_v
         w << R"=====("></div>)=====" << end_of_line;
     }
 
-    std::stringstream ss;
-    ss.imbue(std::locale("C"));
+    budget::output_buffer ss;
 
     ss << R"=====(Highcharts.chart(')=====";
     ss << id;
@@ -1098,7 +1219,7 @@ std::stringstream budget::start_chart_base(budget::html_writer& w, std::string_v
     return ss;
 }
 
-std::stringstream budget::start_chart(
+budget::output_buffer budget::start_chart(
         budget::html_writer& w, std::string_view title, std::string_view chart_type, std::string_view id, std::string_view style) {
     auto ss = start_chart_base(w, chart_type, id, style);
 
@@ -1109,7 +1230,7 @@ std::stringstream budget::start_chart(
     return ss;
 }
 
-std::stringstream budget::start_time_chart(
+budget::output_buffer budget::start_time_chart(
         budget::html_writer& w, std::string_view title, std::string_view chart_type, std::string_view id, std::string_view style) {
     // Note: Not nice but we are simply injecting zoomType here
     auto ss = start_chart_base(w, std::string(chart_type) + "', zoomType: 'x", id, style);
@@ -1123,16 +1244,28 @@ std::stringstream budget::start_time_chart(
     return ss;
 }
 
-void budget::end_chart(budget::html_writer& w, std::stringstream& ss) {
+void budget::end_chart(budget::html_writer& w, budget::output_buffer& ss) {
+    ss << R"=====(});)=====";
+
+    // The chart data can be large, the buffer is moved rather than copied
+    w.defer_script(std::move(ss).str());
+}
+
+void budget::end_data_chart(budget::html_writer& w, budget::output_buffer& ss, std::string_view id, std::string_view url) {
+    w.use_module("data-series");
+
+    // The series are fetched from the data endpoint once the chart is created
+    ss << "series: []";
     ss << R"=====(});)=====";
+    ss << "budget_fetch_series('" << id << "', '" << url << "');";
 
-    w.defer_script(ss.str());
+    w.defer_script(std::move(ss).str());
 }
 
 namespace {
 
 template <size_t N>
-void add_average_n_serie(std::stringstream& ss, const std::vector<budget::money>& serie, const std::vector<std::string>& dates) {
+void add_average_n_serie(budget::output_buffer& ss, const std::vector<budget::money>& serie, const std::vector<std::string>& dates) {
     ss << "{ type: 'line', name: '" << N << " months average',";
     ss << "data: [";
 
@@ -1157,15 +1290,15 @@ void add_average_n_serie(std::stringstream& ss, const std::vector<budget::money>
 
 } // namespace
 
-void budget::add_average_12_serie(std::stringstream& ss, const std::vector<budget::money>& serie, const std::vector<std::string>& dates) {
+void budget::add_average_12_serie(budget::output_buffer& ss, const std::vector<budget::money>& serie, const std::vector<std::string>& dates) {
     add_average_n_serie<12>(ss, serie, dates);
 }
 
-void budget::add_average_24_serie(std::stringstream& ss, const std::vector<budget::money>& serie, const std::vector<std::string>& dates) {
+void budget::add_average_24_serie(budget::output_buffer& ss, const std::vector<budget::money>& serie, const std::vector<std::string>& dates) {
     add_average_n_serie<24>(ss, serie, dates);
 }
 
-void budget::add_average_5_serie(std::stringstream& ss, std::vector<budget::money> serie, std::vector<std::string> dates) {
+void budget::add_average_5_serie(budget::output_buffer& ss, std::vector<budget::money> serie, std::vector<std::string> dates) {
     ss << "{ name: '5 year average',";
     ss << "data: [";
 
@@ -1188,10 +1321,10 @@ void budget::add_average_5_serie(std::stringstream& ss, std::vector<budget::mone
     ss << "]},";
 }
 
-void budget::add_raw_account_picker(budget::writer& w, budget::date day, std::string_view default_value, std::string_view name) {
+void budget::add_raw_account_picker(budget::html_writer& w, budget::date day, std::string_view default_value, std::string_view name) {
     w << std::format(R"=====(<select class="form-control" id="{}" name="{}">)=====", name, name);
 
-    for (const auto& account : all_accounts(w.cache, day.year(), day.month())) {
+    for (const auto& account : all_accounts(w.data(), day.year(), day.month())) {
         if (budget::to_string(account.id) == default_value) {
             w << "<option selected value=\"" << account.id << "\">" << account.name << "</option>";
         } else {
@@ -1202,7 +1335,7 @@ void budget::add_raw_account_picker(budget::writer& w, budget::date day, std::st
     w << "</select>";
 }
 
-void budget::add_account_picker(budget::writer& w, budget::date day, std::string_view default_value) {
+void budget::add_account_picker(budget::html_writer& w, budget::date day, std::string_view default_value) {
     w << R"=====(
             <div class="form-group">
                 <label for="input_account">Account</label>
@@ -1228,7 +1361,7 @@ void budget::add_account_picker_by_name(
         }
     }
 
-    for (const auto& account : all_accounts(w.cache, day.year(), day.month())) {
+    for (const auto& account : all_accounts(w.data(), day.year(), day.month())) {
         if (account.name == default_value) {
             w << "<option selected value=\"" << account.name << "\">" << account.name << "</option>";
         } else {
@@ -1239,14 +1372,14 @@ void budget::add_account_picker_by_name(
     w << R"=====(</select></div>)=====";
 }
 
-void budget::add_share_asset_picker(budget::writer& w, std::string_view default_value) {
+void budget::add_share_asset_picker(budget::html_writer& w, std::string_view default_value) {
     w << R"=====(
             <div class="form-group">
                 <label for="input_asset">Asset</label>
                 <select class="form-control" id="input_asset" name="input_asset">
     )=====";
 
-    for (const auto& asset : w.cache.user_assets() | share_based_only) {
+    for (const auto& asset : w.data().user_assets() | share_based_only) {
         if (budget::to_string(asset.id) == default_value) {
             w << "<option selected value=\"" << asset.id << "\">" << asset.name << "</option>";
         } else {
@@ -1260,14 +1393,14 @@ void budget::add_share_asset_picker(budget::writer& w, std::string_view default_
     )=====";
 }
 
-void budget::add_value_asset_picker(budget::writer& w, std::string_view default_value) {
+void budget::add_value_asset_picker(budget::html_writer& w, std::string_view default_value) {
     w << R"=====(
             <div class="form-group">
                 <label for="input_asset">Asset</label>
                 <select class="form-control" id="input_asset" name="input_asset">
     )=====";
 
-    for (const auto& asset : w.cache.user_assets() | not_share_based) {
+    for (const auto& asset : w.data().user_assets() | not_share_based) {
         if (budget::to_string(asset.id) == default_value) {
             w << "<option selected value=\"" << asset.id << "\">" << asset.name << "</option>";
         } else {
@@ -1281,14 +1414,14 @@ void budget::add_value_asset_picker(budget::writer& w, std::string_view default_
     )=====";
 }
 
-void budget::add_active_share_asset_picker(budget::writer& w, std::string_view default_value) {
+void budget::add_active_share_asset_picker(budget::html_writer& w, std::string_view default_value) {
     w << R"=====(
             <div class="form-group">
                 <label for="input_asset">Asset</label>
                 <select class="form-control" id="input_asset" name="input_asset">
     )=====";
 
-    for (const auto& asset : w.cache.active_user_assets() | share_based_only) {
+    for (const auto& asset : w.data().active_user_assets() | share_based_only) {
         if (budget::to_string(asset.id) == default_value) {
             w << "<option selected value=\"" << asset.id << "\">" << asset.name << "</option>";
         } else {
@@ -1302,14 +1435,14 @@ void budget::add_active_share_asset_picker(budget::writer& w, std::string_view d
     )=====";
 }
 
-void budget::add_active_value_asset_picker(budget::writer& w, std::string_view default_value) {
+void budget::add_active_value_asset_picker(budget::html_writer& w, std::string_view default_value) {
     w << R"=====(
             <div class="form-group">
                 <label for="input_asset">Asset</label>
                 <select class="form-control" id="input_asset" name="input_asset">
     )=====";
 
-    for (const auto& asset : w.cache.active_user_assets() | not_share_based) {
+    for (const auto& asset : w.data().active_user_assets() | not_share_based) {
         if (budget::to_string(asset.id) == default_value) {
             w << "<option selected value=\"" << asset.id << "\">" << asset.name << "</option>";
         } else {
@@ -0,0 +1,527 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <unordered_map>
+
+#include "pages/time_series.hpp"
+#include "currency.hpp"
+#include "data_cache.hpp"
+#include "share.hpp"
+
+using namespace budget;
+
+namespace {
+
+std::chrono::sys_days to_sys_days(budget::date d) {
+    return std::chrono::year_month_day{std::chrono::year(static_cast<int>(d.year().value)),
+                                       std::chrono::month(static_cast<unsigned>(d.month().value)),
+                                       std::chrono::day(static_cast<unsigned>(d.day().value))};
+}
+
+template <typename Functor>
+daily_serie sweep_serie(asset_sweep sweep, Functor functor) {
+    daily_serie serie;
+    serie.first = sweep.day();
+
+    for (; sweep.valid(); sweep.advance()) {
+        serie.values.push_back(functor(sweep));
+    }
+
+    return serie;
+}
+
+float fi_allocation(const auto& asset_or_liability) {
+    float allocation = 0.0f;
+
+    for (const auto& clas : all_asset_classes()) {
+        if (clas.fi) {
+            allocation += float(get_asset_class_allocation(asset_or_liability, clas)) / 100.0f;
+        }
+    }
+
+    return allocation;
+}
+
+template <typename T>
+allocation_matrix make_allocation_matrix_impl(const std::vector<T>& rows, const std::vector<budget::asset_class>& classes) {
+    allocation_matrix matrix;
+    matrix.rows    = rows.size();
+    matrix.columns = classes.size();
+    matrix.fractions.resize(matrix.rows * matrix.columns);
+
+    for (size_t i = 0; i < rows.size(); ++i) {
+        for (size_t j = 0; j < classes.size(); ++j) {
+            matrix.fractions[i * matrix.columns + j] = float(get_asset_class_allocation(rows[i], classes[j])) / 100.0f;
+        }
+    }
+
+    return matrix;
+}
+
+// Largest-Triangle-Three-Buckets between the fixed points first and last,
+// selecting count points strictly between them
+void downsample_segment(const std::vector<double>& values, size_t first, size_t last, size_t count, std::vector<size_t>& selected) {
+    const size_t inner = last - first - 1;
+
+    if (count >= inner) {
+        for (size_t i = first + 1; i < last; ++i) {
+            selected.push_back(i);
+        }
+
+        return;
+    }
+
+    const double bucket = static_cast<double>(inner) / static_cast<double>(count);
+
+    auto bucket_begin = [&](size_t j) { return first + 1 + static_cast<size_t>(std::floor(static_cast<double>(j) * bucket)); };
+
+    size_t previous = first;
+
+    for (size_t j = 0; j < count; ++j) {
+        const size_t begin = bucket_begin(j);
+        const size_t end   = j + 1 == count ? last : bucket_begin(j + 1);
+
+        // The third point of the triangle is the average of the next bucket
+        double next_x = static_cast<double>(last);
+        double next_y = values[last];
+
+        if (j + 1 < count) {
+            const size_t next_end = j + 2 == count ? last : bucket_begin(j + 2);
+
+            next_x = 0.0;
+            next_y = 0.0;
+
+            for (size_t i = end; i < next_end; ++i) {
+                next_x += static_cast<double>(i);
+                next_y += values[i];
+            }
+
+            next_x /= static_cast<double>(next_end - end);
+            next_y /= static_cast<double>(next_end - end);
+        }
+
+        const auto prev_x = static_cast<double>(previous);
+        const auto prev_y = values[previous];
+
+        size_t best      = begin;
+        double best_area = -1.0;
+
+        for (size_t i = begin; i < end; ++i) {
+            const double area = std::abs((prev_x - next_x) * (values[i] - prev_y) - (prev_x - static_cast<double>(i)) * (next_y - prev_y));
+
+            if (area > best_area) {
+                best_area = area;
+                best      = i;
+            }
+        }
+
+        selected.push_back(best);
+        previous = best;
+    }
+}
+
+} // end of anonymous namespace
+
+int64_t budget::days_between(budget::date a, budget::date b) {
+    return (to_sys_days(b) - to_sys_days(a)).count();
+}
+
+int64_t budget::epoch_millis(budget::date d) {
+    return to_sys_days(d).time_since_epoch().count() * int64_t(86400000);
+}
+
+budget::money budget::daily_serie::at(budget::date d) const {
+    if (values.empty()) {
+        return {};
+    }
+
+    const auto offset = days_between(first, d);
+
+    if (offset < 0) {
+        return {};
+    }
+
+    if (static_cast<size_t>(offset) >= values.size()) {
+        return values.back();
+    }
+
+    return values[offset];
+}
+
+budget::asset_sweep::asset_sweep(std::vector<budget::asset> assets, std::vector<budget::liability> liabilities, budget::date first, budget::date last) :
+        sweep_assets(std::move(assets)), sweep_liabilities(std::move(liabilities)), current(first), last(last) {
+    std::unordered_map<size_t, size_t> asset_indices;
+    std::unordered_map<size_t, size_t> liability_indices;
+
+    auto currency_index = [this](const std::string& currency) {
+        if (auto it = std::ranges::find(currencies, currency); it != currencies.end()) {
+            return static_cast<size_t>(it - currencies.begin());
+        }
+
+        currencies.push_back(currency);
+        return currencies.size() - 1;
+    };
+
+    for (size_t i = 0; i < sweep_assets.size(); ++i) {
+        asset_indices[sweep_assets[i].id] = i;
+        asset_currency.push_back(currency_index(sweep_assets[i].currency));
+    }
+
+    for (size_t i = 0; i < sweep_liabilities.size(); ++i) {
+        liability_indices[sweep_liabilities[i].id] = i;
+        liability_currency.push_back(currency_index(sweep_liabilities[i].currency));
+    }
+
+    // Gather all the events that concern the swept assets and liabilities
+
+    for (const auto& asset_value : all_asset_values()) {
+        if (asset_value.liability) {
+            if (auto it = liability_indices.find(asset_value.asset_id); it != liability_indices.end()) {
+                events.push_back({asset_value.set_date, it->second, true, false, 0, asset_value.amount});
+            }
+        } else {
+            if (auto it = asset_indices.find(asset_value.asset_id); it != asset_indices.end() && !sweep_assets[it->second].share_based) {
+                events.push_back({asset_value.set_date, it->second, false, false, 0, asset_value.amount});
+            }
+        }
+    }
+
+    for (const auto& asset_share : all_asset_shares()) {
+        if (auto it = asset_indices.find(asset_share.asset_id); it != asset_indices.end() && sweep_assets[it->second].share_based) {
+            events.push_back({asset_share.date, it->second, false, true, asset_share.shares, {}});
+        }
+    }
+
+    // The stable sort keeps the insertion order for values set on the same day
+    std::ranges::stable_sort(events, [](const event& lhs, const event& rhs) { return lhs.date < rhs.date; });
+
+    shares.resize(sweep_assets.size(), 0);
+    raw_asset_values.resize(sweep_assets.size());
+    raw_liability_values.resize(sweep_liabilities.size());
+
+    asset_values.resize(sweep_assets.size());
+    asset_values_conv.resize(sweep_assets.size());
+    liability_values_conv.resize(sweep_liabilities.size());
+
+    if (valid()) {
+        update();
+    }
+}
+
+bool budget::asset_sweep::valid() const {
+    return current <= last;
+}
+
+void budget::asset_sweep::advance() {
+    current += days(1);
+    ++current_index;
+
+    if (valid()) {
+        update();
+    }
+}
+
+void budget::asset_sweep::update() {
+    // Consume all the events until the current day
+
+    while (next_event < events.size() && events[next_event].date <= current) {
+        const auto& event = events[next_event];
+
+        if (event.liability) {
+            raw_liability_values[event.target] = event.amount;
+        } else if (event.share) {
+            shares[event.target] += event.shares;
+        } else {
+            raw_asset_values[event.target] = event.amount;
+        }
+
+        ++next_event;
+    }
+
+    // The exchange rates only need to be computed once per currency
+
+    std::vector<double> rates(currencies.size());
+    for (size_t c = 0; c < currencies.size(); ++c) {
+        rates[c] = exchange_rate(currencies[c], current);
+    }
+
+    for (size_t i = 0; i < sweep_assets.size(); ++i) {
+        const auto& asset = sweep_assets[i];
+
+        if (asset.share_based) {
+            if (shares[i] > 0) {
+                asset_values[i] = static_cast<float>(shares[i]) * share_price(asset.ticker, current);
+            } else {
+                asset_values[i] = {};
+            }
+        } else {
+            asset_values[i] = raw_asset_values[i];
+        }
+
+        asset_values_conv[i] = asset_values[i] * rates[asset_currency[i]];
+    }
+
+    for (size_t i = 0; i < sweep_liabilities.size(); ++i) {
+        liability_values_conv[i] = raw_liability_values[i] * rates[liability_currency[i]];
+    }
+}
+
+daily_serie budget::asset_value_serie(data_cache& cache, const budget::asset& asset) {
+    asset_sweep sweep({asset}, {}, asset_start_date(cache, asset), budget::local_day());
+    return sweep_serie(std::move(sweep), [](const asset_sweep& sweep) { return sweep.asset_value(0); });
+}
+
+daily_serie budget::asset_value_conv_serie(data_cache& cache, const budget::asset& asset) {
+    asset_sweep sweep({asset}, {}, asset_start_date(cache, asset), budget::local_day());
+    return sweep_serie(std::move(sweep), [](const asset_sweep& sweep) { return sweep.asset_value_conv(0); });
+}
+
+daily_serie budget::net_worth_serie(data_cache& cache) {
+    asset_sweep sweep(cache.user_assets(), cache.liabilities(), asset_start_date(cache), budget::local_day());
+
+    return sweep_serie(std::move(sweep), [](const asset_sweep& sweep) {
+        budget::money sum;
+
+        for (size_t i = 0; i < sweep.assets().size(); ++i) {
+            sum += sweep.asset_value_conv(i);
+        }
+
+        for (size_t i = 0; i < sweep.liabilities().size(); ++i) {
+            sum -= sweep.liability_value_conv(i);
+        }
+
+        return sum;
+    });
+}
+
+daily_serie budget::fi_net_worth_serie(data_cache& cache) {
+    asset_sweep sweep(cache.user_assets(), cache.liabilities(), asset_start_date(cache), budget::local_day());
+
+    // The FI allocation of each asset does not change over time
+    std::vector<float> asset_fi;
+    std::vector<float> liability_fi;
+
+    for (const auto& asset : sweep.assets()) {
+        asset_fi.push_back(fi_allocation(asset));
+    }
+
+    for (const auto& liability : sweep.liabilities()) {
+        liability_fi.push_back(fi_allocation(liability));
+    }
+
+    return sweep_serie(std::move(sweep), [&asset_fi, &liability_fi](const asset_sweep& sweep) {
+        budget::money sum;
+
+        for (size_t i = 0; i < sweep.assets().size(); ++i) {
+            sum += sweep.asset_value_conv(i) * asset_fi[i];
+        }
+
+        for (size_t i = 0; i < sweep.liabilities().size(); ++i) {
+            sum -= sweep.liability_value_conv(i) * liability_fi[i];
+        }
+
+        return sum;
+    });
+}
+
+allocation_matrix budget::make_allocation_matrix(const std::vector<budget::asset>& assets, const std::vector<budget::asset_class>& classes) {
+    return make_allocation_matrix_impl(assets, classes);
+}
+
+allocation_matrix budget::make_allocation_matrix(const std::vector<budget::liability>& liabilities, const std::vector<budget::asset_class>& classes) {
+    return make_allocation_matrix_impl(liabilities, classes);
+}
+
+std::vector<daily_serie> budget::asset_class_series(data_cache& cache, bool portfolio) {
+    std::vector<budget::asset>     assets;
+    std::vector<budget::liability> liabilities;
+
+    for (const auto& asset : cache.user_assets()) {
+        if (!portfolio || asset.portfolio) {
+            assets.push_back(asset);
+        }
+    }
+
+    if (!portfolio) {
+        for (const auto& liability : cache.liabilities()) {
+            liabilities.push_back(liability);
+        }
+    }
+
+    const std::vector<budget::asset_class> classes(cache.asset_classes().begin(), cache.asset_classes().end());
+
+    const auto asset_matrix     = make_allocation_matrix(assets, classes);
+    const auto liability_matrix = make_allocation_matrix(liabilities, classes);
+
+    asset_sweep sweep(std::move(assets), std::move(liabilities), asset_start_date(cache), budget::local_day());
+
+    std::vector<daily_serie> series(classes.size());
+    for (auto& serie : series) {
+        serie.first = sweep.day();
+    }
+
+    std::vector<budget::money> sums(classes.size());
+
+    // Each converted value is computed once per day and fanned out into all the classes
+    for (; sweep.valid(); sweep.advance()) {
+        std::ranges::fill(sums, budget::money());
+
+        for (size_t i = 0; i < sweep.assets().size(); ++i) {
+            if (auto value = sweep.asset_value_conv(i); value) {
+                for (size_t j = 0; j < classes.size(); ++j) {
+                    if (const auto fraction = asset_matrix(i, j); fraction > 0.0f) {
+                        sums[j] += value * fraction;
+                    }
+                }
+            }
+        }
+
+        for (size_t i = 0; i < sweep.liabilities().size(); ++i) {
+            if (auto value = sweep.liability_value_conv(i); value) {
+                for (size_t j = 0; j < classes.size(); ++j) {
+                    if (const auto fraction = liability_matrix(i, j); fraction > 0.0f) {
+                        sums[j] -= value * fraction;
+                    }
+                }
+            }
+        }
+
+        for (size_t j = 0; j < classes.size(); ++j) {
+            series[j].values.push_back(sums[j]);
+        }
+    }
+
+    return series;
+}
+
+daily_serie budget::portfolio_serie(data_cache& cache) {
+    std::vector<budget::asset> assets;
+
+    for (const auto& asset : cache.user_assets()) {
+        if (asset.portfolio) {
+            assets.push_back(asset);
+        }
+    }
+
+    asset_sweep sweep(std::move(assets), {}, asset_start_date(cache), budget::local_day());
+
+    return sweep_serie(std::move(sweep), [](const asset_sweep& sweep) {
+        budget::money sum;
+
+        for (size_t i = 0; i < sweep.assets().size(); ++i) {
+            sum += sweep.asset_value_conv(i);
+        }
+
+        return sum;
+    });
+}
+
+std::map<std::string, daily_serie, std::less<>> budget::currency_series(data_cache& cache, bool portfolio) {
+    std::vector<budget::asset>     assets;
+    std::vector<budget::liability> liabilities;
+
+    for (const auto& asset : cache.user_assets()) {
+        if (!portfolio || asset.portfolio) {
+            assets.push_back(asset);
+        }
+    }
+
+    if (!portfolio) {
+        for (const auto& liability : cache.liabilities()) {
+            liabilities.push_back(liability);
+        }
+    }
+
+    std::map<std::string, daily_serie, std::less<>> series;
+
+    asset_sweep sweep(std::move(assets), std::move(liabilities), asset_start_date(cache), budget::local_day());
+
+    std::vector<daily_serie*> asset_series;
+    std::vector<daily_serie*> liability_series;
+
+    for (const auto& asset : sweep.assets()) {
+        auto& serie = series[asset.currency];
+        serie.first = sweep.day();
+        asset_series.push_back(&serie);
+    }
+
+    // Only the currencies of the assets are displayed
+    for (const auto& liability : sweep.liabilities()) {
+        auto it = series.find(liability.currency);
+        liability_series.push_back(it == series.end() ? nullptr : &it->second);
+    }
+
+    for (; sweep.valid(); sweep.advance()) {
+        for (auto& [currency, serie] : series) {
+            serie.values.emplace_back();
+        }
+
+        for (size_t i = 0; i < sweep.assets().size(); ++i) {
+            asset_series[i]->values.back() += sweep.asset_value_conv(i);
+        }
+
+        for (size_t i = 0; i < sweep.liabilities().size(); ++i) {
+            if (liability_series[i]) {
+                liability_series[i]->values.back() -= sweep.liability_value_conv(i);
+            }
+        }
+    }
+
+    return series;
+}
+
+std::vector<size_t> budget::downsample(const std::vector<double>& values, size_t target, const std::vector<size_t>& kept) {
+    std::vector<size_t> selected;
+
+    if (values.empty()) {
+        return selected;
+    }
+
+    // The fixed points split the values in segments
+    std::vector<size_t> fixed{0};
+
+    for (auto index : kept) {
+        if (index > fixed.back() && index < values.size() - 1) {
+            fixed.push_back(index);
+        }
+    }
+
+    if (values.size() > 1) {
+        fixed.push_back(values.size() - 1);
+    }
+
+    // The kept indices count against the target, only some of them are kept if they do not fit
+    if (target >= 2 && fixed.size() > target) {
+        std::vector<size_t> thinned;
+        thinned.reserve(target);
+
+        for (size_t i = 0; i < target; ++i) {
+            thinned.push_back(fixed[i * (fixed.size() - 1) / (target - 1)]);
+        }
+
+        fixed = std::move(thinned);
+    }
+
+    // The remaining budget is spread between the segments, by length
+    const size_t budget = target > fixed.size() ? target - fixed.size() : 0;
+
+    selected.push_back(fixed.front());
+
+    for (size_t s = 0; s + 1 < fixed.size(); ++s) {
+        const size_t length = fixed[s + 1] - fixed[s];
+        const size_t count  = budget * length / values.size();
+
+        downsample_segment(values, fixed[s], fixed[s + 1], count, selected);
+
+        selected.push_back(fixed[s + 1]);
+    }
+
+    return selected;
+}
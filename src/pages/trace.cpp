@@ -0,0 +1,107 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include "pages/trace.hpp"
+
+#ifdef BUDGET_TRACE
+
+#include <format>
+#include <string>
+
+#include "http.hpp"
+
+using namespace budget;
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+thread_local trace_recorder* current_recorder = nullptr;
+
+int64_t elapsed_us(const trace_recorder& recorder) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(clock_type::now() - recorder.start).count();
+}
+
+std::string trace_json(const trace_recorder& recorder) {
+    std::string json = R"({"traceEvents":[)";
+
+    for (size_t i = 0; i < recorder.events.size(); ++i) {
+        const auto& event = recorder.events[i];
+
+        if (i) {
+            json += ',';
+        }
+
+        // The names are literals of the source code, they do not need escaping
+        json += std::format(R"({{"name":"{}","ph":"X","ts":{},"dur":{},"pid":1,"tid":1}})", event.name, event.start, event.duration);
+    }
+
+    json += "]}";
+
+    return json;
+}
+
+std::string trace_html(const trace_recorder& recorder) {
+    std::string html = R"(<div class="container"><h3>Trace</h3><pre>)";
+
+    for (const auto& event : recorder.events) {
+        html += std::format("{:>10.3f}ms {}{}\n", static_cast<double>(event.duration) / 1000.0, std::string(2 * event.depth, ' '), event.name);
+    }
+
+    html += "</pre></div>";
+
+    return html;
+}
+
+} // end of anonymous namespace
+
+budget::trace_recorder::trace_recorder(bool enabled) : start(clock_type::now()), enabled(enabled) {
+    if (enabled) {
+        current_recorder = this;
+    }
+}
+
+budget::trace_recorder::~trace_recorder() {
+    if (enabled) {
+        current_recorder = nullptr;
+    }
+}
+
+void budget::trace_recorder::write(const httplib::Request& req, httplib::Response& res) {
+    if (!enabled) {
+        return;
+    }
+
+    current_recorder = nullptr;
+
+    if (req.get_param_value("trace") == "json") {
+        res.set_content(trace_json(*this), "application/json");
+        return;
+    }
+
+    if (auto end = res.body.rfind("</body>"); end != std::string::npos) {
+        res.body.insert(end, trace_html(*this));
+    } else {
+        res.body += trace_html(*this);
+    }
+}
+
+budget::trace_span::trace_span(const char* name) : recorder(current_recorder) {
+    if (recorder) {
+        index = recorder->events.size();
+        recorder->events.push_back({name, elapsed_us(*recorder), 0, recorder->depth++});
+    }
+}
+
+budget::trace_span::~trace_span() {
+    if (recorder) {
+        recorder->events[index].duration = elapsed_us(*recorder) - recorder->events[index].start;
+        --recorder->depth;
+    }
+}
+
+#endif
@@ -10,6 +10,7 @@
 #include "pages/html_writer.hpp"
 #include "pages/wishes_pages.hpp"
 #include "http.hpp"
+#include "lazy_data.hpp"
 
 using namespace budget;
 
@@ -80,24 +81,32 @@ void add_urgency_picker(budget::writer& w, unsigned long urgency) {
 } // namespace
 
 void budget::wishes_list_page(html_writer& w) {
+    require_wishes();
+
     budget::list_wishes(w);
 
     make_tables_sortable(w);
 }
 
 void budget::wishes_status_page(html_writer& w) {
+    require_wishes();
+
     budget::status_wishes(w);
 
     make_tables_sortable(w);
 }
 
 void budget::wishes_estimate_page(html_writer& w) {
+    require_wishes();
+
     budget::estimate_wishes(w);
 
     make_tables_sortable(w);
 }
 
 void budget::add_wishes_page(html_writer& w) {
+    require_wishes();
+
     w << title_begin << "New Wish" << title_end;
 
     form_begin(w, "/api/wishes/add/", "/wishes/add/");
@@ -111,6 +120,8 @@ void budget::add_wishes_page(html_writer& w) {
 }
 
 void budget::edit_wishes_page(html_writer& w, const httplib::Request& req) {
+    require_wishes();
+
     if (!validate_parameters(w, req, {"input_id", "back_page"})) {
         return;
     }
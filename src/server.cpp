@@ -5,9 +5,14 @@
 //  http://opensource.org/licenses/MIT)
 //=======================================================================
 
+#include <chrono>
 #include <condition_variable>
+#include <future>
+#include <map>
 #include <set>
+#include <string_view>
 #include <thread>
+#include <vector>
 
 #include "accounts.hpp"
 #include "api/server_api.hpp"
@@ -15,19 +20,20 @@
 #include "config.hpp"
 #include "currency.hpp"
 #include "data.hpp"
-#include "debts.hpp"
+#include "data_lock.hpp"
 #include "earnings.hpp"
 #include "expenses.hpp"
-#include "fortune.hpp"
 #include "http.hpp"
 #include "incomes.hpp"
 #include "liabilities.hpp"
 #include "logging.hpp"
-#include "objectives.hpp"
+#include "pages/page_cache.hpp"
 #include "pages/server_pages.hpp"
 #include "recurring.hpp"
+#include "server_metrics.hpp"
+#include "server_pool.hpp"
 #include "share.hpp"
-#include "wishes.hpp"
+#include "utils.hpp"
 
 using namespace budget;
 
@@ -62,6 +68,60 @@ void install_signal_handler() {
     LOG_F(INFO, "Installed the signal handler");
 }
 
+// Request the configured routes once the server is ready, to fill the page cache
+// before the first real visit
+void warm_up(const httplib::Server& server, const std::string& listen, int port) {
+    // The server may take a moment to start, or fail to start
+    for (size_t i = 0; i < 1000 && !server.is_running(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    if (!server.is_running()) {
+        return;
+    }
+
+    const auto routes = config_value("server_warmup_routes", "/,/net_worth/graph/,/overview/,/data/net_worth/daily/?format=columnar");
+
+    // The wildcard addresses are reached on the loopback
+    httplib::Client client(listen == "0.0.0.0" || listen == "::" ? "127.0.0.1" : listen, port);
+    client.set_keep_alive(true);
+
+    if (is_secure()) {
+#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
+        client.set_digest_auth(get_web_user(), get_web_password());
+#else
+        LOG_F(WARNING, "Warm-up: Digest authentication is not supported, skipped");
+        return;
+#endif
+    }
+
+    // The same representation as the browsers
+    const httplib::Headers headers{{"User-Agent", "budgetwarrior warm-up"}, {"Accept-Encoding", "gzip"}};
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (auto route : budget::splitv(routes, ',')) {
+        if (route.empty() || !cron) {
+            continue;
+        }
+
+        const auto route_start = std::chrono::steady_clock::now();
+
+        auto response = client.Get(std::string(route), headers);
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - route_start);
+
+        if (response) {
+            LOG_F(INFO, "Warm-up: {} in {}ms (status {}, {} bytes)", route, elapsed.count(), response->status, response->body.size());
+        } else {
+            LOG_F(WARNING, "Warm-up: {} failed after {}ms", route, elapsed.count());
+        }
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    LOG_F(INFO, "Warm-up: Done in {}ms", elapsed.count());
+}
+
 bool start_server() {
     // Name the thread
     const pthread_t self = pthread_self();
@@ -72,8 +132,11 @@ bool start_server() {
 
     httplib::Server server;
 
+    configure_server_pool(server);
+
     load_pages(server);
     load_api(server);
+    install_request_metrics(server);
 
     install_signal_handler();
 
@@ -81,6 +144,12 @@ bool start_server() {
     auto listen = get_server_listen();
     server_ptr  = &server;
 
+    // Optionally, render the most used routes as soon as the server listens
+    std::jthread warmup_thread;
+    if (config_value("server_warmup", "false") == "true") {
+        warmup_thread = std::jthread([&server, &listen, port]() { warm_up(server, listen, port); });
+    }
+
     // Listen
     LOG_F(INFO, "Server is starting to listen on {}:{}", listen, port);
     if (!server.listen(listen.c_str(), port)) {
@@ -116,13 +185,26 @@ void start_cron_loop() {
         ++hours;
 
         LOG_F(INFO, "cron: Check for recurrings");
-        check_for_recurrings();
+        {
+            auto data_lock = write_data();
+            check_for_recurrings();
+
+            // The snapshot must not be reused with the new recurrings
+            bump_data_generation();
+        }
 
         // We save the cache once per day
         if (hours % 24 == 0) {
             LOG_F(INFO, "cron: Save the caches");
             save_currency_cache();
             save_share_price_cache();
+            save_page_cache();
+
+            auto stats = get_page_cache_stats();
+            LOG_F(INFO, "cron: Page cache: {} hits, {} misses, {} pages, {} bytes", stats.hits, stats.misses, stats.entries, stats.bytes);
+
+            auto pool = get_server_pool_stats();
+            LOG_F(INFO, "cron: Server pool: {} connections, {} rejected, {}us max wait", pool.connections, pool.rejected, pool.wait_max_us);
         }
 
         // Every four hours, we refresh the currency cache
@@ -135,24 +217,70 @@ void start_cron_loop() {
         // Every hour, we try to prefetch value for new days
         LOG_F(INFO, "cron: Prefetch the share cache");
         budget::prefetch_share_price_cache();
+
+        // The recurrings, rates and prices may have changed the rendered pages
+        bump_data_generation();
     }
 
     LOG_F(INFO, "cron: Cron thread has exited");
 }
 
+// The fortunes, wishes, debts and objectives are loaded on first use (see lazy_data.hpp)
+struct data_loader {
+    const char*              name;
+    void                     (*load)();
+    std::vector<const char*> dependencies; // Must be declared before
+};
+
+const std::vector<data_loader> data_loaders{
+        {"accounts", &load_accounts, {}},
+        {"incomes", &load_incomes, {}},
+        {"expenses", &load_expenses, {}},
+        {"earnings", &load_earnings, {}},
+        {"assets", &load_assets, {}},
+        {"liabilities", &load_liabilities, {}},
+        {"recurrings", &load_recurrings, {"accounts"}}, // The recurrings reference the accounts
+};
+
+void run_loader(const data_loader& loader, const std::vector<std::shared_future<void>>& dependencies) {
+    for (const auto& dependency : dependencies) {
+        dependency.get();
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    loader.load();
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    LOG_F(INFO, "Loaded the {} in {}ms", loader.name, elapsed.count());
+}
+
+// Load the data files concurrently, each as soon as its dependencies are loaded
 void load() {
-    load_accounts();
-    load_incomes();
-    load_expenses();
-    load_earnings();
-    load_assets();
-    load_liabilities();
-    load_objectives();
-    load_wishes();
-    load_fortunes();
-    load_recurrings();
-    load_debts();
-    load_wishes();
+    const auto start = std::chrono::steady_clock::now();
+
+    std::map<std::string_view, std::shared_future<void>> loaded;
+
+    for (const auto& loader : data_loaders) {
+        std::vector<std::shared_future<void>> dependencies;
+        for (const auto* dependency : loader.dependencies) {
+            dependencies.push_back(loaded.at(dependency));
+        }
+
+        loaded[loader.name] = std::async(std::launch::async, run_loader, std::cref(loader), std::move(dependencies)).share();
+    }
+
+    // Wait for all the loaders before rethrowing any error
+    for (auto& [name, future] : loaded) {
+        future.wait();
+    }
+
+    for (auto& [name, future] : loaded) {
+        future.get();
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    LOG_F(INFO, "Loaded all the data in {}ms", elapsed.count());
 }
 
 } // end of anonymous namespace
@@ -209,6 +337,9 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    // Restore the rendered pages, if the data did not change since the shutdown
+    load_page_cache();
+
     std::atomic<bool> success = false;
 
     {
@@ -229,5 +360,8 @@ int main(int argc, char** argv) {
 
     save_config();
 
+    // Last, so that the snapshot matches all the saved files
+    save_page_cache();
+
     return 0;
 }
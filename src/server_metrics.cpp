@@ -0,0 +1,206 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <array>
+#include <chrono>
+#include <format>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#include "server_metrics.hpp"
+#include "server_pool.hpp"
+#include "pages/page_cache.hpp"
+
+#include "config.hpp"
+#include "http.hpp"
+#include "logging.hpp"
+#include "utils.hpp"
+
+using namespace budget;
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+// The upper bounds of the latency buckets, in seconds
+constexpr std::array<double, 13> bucket_bounds{0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0};
+
+struct route_metrics {
+    std::array<size_t, bucket_bounds.size() + 1> buckets{}; // The last one is +Inf
+    size_t                                       count   = 0;
+    double                                       seconds = 0.0;
+    size_t                                       bytes   = 0;
+};
+
+std::mutex                                        metrics_lock;
+std::map<std::string, route_metrics, std::less<>> routes;
+
+// A request is completely handled by one thread, from routing to logging.
+// Unset for the requests rejected before routing (malformed for instance).
+thread_local clock_type::time_point request_start;
+
+size_t slow_request_threshold() {
+    static const size_t threshold = to_number<size_t>(config_value("server_slow_request", "1000"));
+    return threshold;
+}
+
+std::string route_of(std::string_view path) {
+    std::string route;
+    route.reserve(path.size());
+
+    for (auto segment : budget::splitv(path, '/')) {
+        if (segment.empty()) {
+            continue;
+        }
+
+        route += '/';
+
+        if (segment.find_first_not_of("0123456789") == std::string_view::npos) {
+            route += ":id";
+        } else {
+            route += segment;
+        }
+    }
+
+    route += '/';
+
+    return route;
+}
+
+void record_request(const httplib::Request& req, const httplib::Response& res) {
+    // The start of the previous request on this thread must not be used
+    const auto start = std::exchange(request_start, clock_type::time_point{});
+
+    if (start == clock_type::time_point{}) {
+        return;
+    }
+
+    const auto elapsed = std::chrono::duration<double>(clock_type::now() - start).count();
+
+    // Do not create a route for each unknown path
+    auto route = res.status == 404 ? std::string("unmatched") : route_of(req.path);
+
+    if (auto threshold = slow_request_threshold(); threshold && elapsed * 1000.0 >= static_cast<double>(threshold)) {
+        LOG_F(WARNING, "Slow request: {} {} took {:.0f}ms ({} bytes, status {})", req.method, req.path, elapsed * 1000.0, res.body.size(), res.status);
+    }
+
+    size_t bucket = 0;
+    while (bucket < bucket_bounds.size() && elapsed > bucket_bounds[bucket]) {
+        ++bucket;
+    }
+
+    std::lock_guard lock(metrics_lock);
+
+    auto& metrics = routes[route];
+    ++metrics.buckets[bucket];
+    ++metrics.count;
+    metrics.seconds += elapsed;
+    metrics.bytes += res.body.size();
+}
+
+// Estimate a quantile from the buckets, interpolating inside the bucket
+double quantile(const route_metrics& metrics, double q) {
+    const double rank  = q * static_cast<double>(metrics.count);
+    double       lower = 0.0;
+    size_t       seen  = 0;
+
+    for (size_t i = 0; i < bucket_bounds.size(); ++i) {
+        if (metrics.buckets[i] && static_cast<double>(seen + metrics.buckets[i]) >= rank) {
+            return lower + (bucket_bounds[i] - lower) * (rank - static_cast<double>(seen)) / static_cast<double>(metrics.buckets[i]);
+        }
+
+        seen += metrics.buckets[i];
+        lower = bucket_bounds[i];
+    }
+
+    // Beyond the last bound, nothing better than the bound is known
+    return bucket_bounds.back();
+}
+
+} // end of anonymous namespace
+
+void budget::install_request_metrics(httplib::Server& server) {
+    server.set_pre_routing_handler([](const httplib::Request& /*req*/, httplib::Response& /*res*/) {
+        request_start = clock_type::now();
+        return httplib::Server::HandlerResponse::Unhandled;
+    });
+
+    server.set_logger([](const httplib::Request& req, const httplib::Response& res) { record_request(req, res); });
+}
+
+std::string budget::prometheus_metrics() {
+    std::string out;
+
+    {
+        std::lock_guard lock(metrics_lock);
+
+        out += "# HELP budget_request_duration_seconds Latency of the requests\n";
+        out += "# TYPE budget_request_duration_seconds histogram\n";
+
+        for (const auto& [route, metrics] : routes) {
+            size_t cumulative = 0;
+
+            for (size_t i = 0; i < bucket_bounds.size(); ++i) {
+                cumulative += metrics.buckets[i];
+                out += std::format("budget_request_duration_seconds_bucket{{route=\"{}\",le=\"{}\"}} {}\n", route, bucket_bounds[i], cumulative);
+            }
+
+            out += std::format("budget_request_duration_seconds_bucket{{route=\"{}\",le=\"+Inf\"}} {}\n", route, metrics.count);
+            out += std::format("budget_request_duration_seconds_sum{{route=\"{}\"}} {}\n", route, metrics.seconds);
+            out += std::format("budget_request_duration_seconds_count{{route=\"{}\"}} {}\n", route, metrics.count);
+        }
+
+        out += "# HELP budget_request_latency_seconds Estimated quantiles of the latency of the requests\n";
+        out += "# TYPE budget_request_latency_seconds summary\n";
+
+        for (const auto& [route, metrics] : routes) {
+            for (const double q : {0.5, 0.95, 0.99}) {
+                out += std::format("budget_request_latency_seconds{{route=\"{}\",quantile=\"{}\"}} {}\n", route, q, quantile(metrics, q));
+            }
+
+            out += std::format("budget_request_latency_seconds_sum{{route=\"{}\"}} {}\n", route, metrics.seconds);
+            out += std::format("budget_request_latency_seconds_count{{route=\"{}\"}} {}\n", route, metrics.count);
+        }
+
+        out += "# HELP budget_response_bytes_total Size of the response bodies\n";
+        out += "# TYPE budget_response_bytes_total counter\n";
+
+        for (const auto& [route, metrics] : routes) {
+            out += std::format("budget_response_bytes_total{{route=\"{}\"}} {}\n", route, metrics.bytes);
+        }
+    }
+
+    auto pool = get_server_pool_stats();
+
+    out += "# TYPE budget_pool_threads gauge\n";
+    out += std::format("budget_pool_threads {}\n", pool.threads);
+    out += "# TYPE budget_pool_queued gauge\n";
+    out += std::format("budget_pool_queued {}\n", pool.queued);
+    out += "# TYPE budget_pool_active gauge\n";
+    out += std::format("budget_pool_active {}\n", pool.active);
+    out += "# HELP budget_pool_connections_total Connections served, each with one or more requests\n";
+    out += "# TYPE budget_pool_connections_total counter\n";
+    out += std::format("budget_pool_connections_total {}\n", pool.connections);
+    out += "# TYPE budget_pool_rejected_total counter\n";
+    out += std::format("budget_pool_rejected_total {}\n", pool.rejected);
+    out += "# TYPE budget_pool_wait_seconds_total counter\n";
+    out += std::format("budget_pool_wait_seconds_total {}\n", static_cast<double>(pool.wait_total_us) / 1e6);
+
+    auto cache = get_page_cache_stats();
+
+    out += "# TYPE budget_page_cache_hits_total counter\n";
+    out += std::format("budget_page_cache_hits_total {}\n", cache.hits);
+    out += "# TYPE budget_page_cache_misses_total counter\n";
+    out += std::format("budget_page_cache_misses_total {}\n", cache.misses);
+    out += "# TYPE budget_page_cache_entries gauge\n";
+    out += std::format("budget_page_cache_entries {}\n", cache.entries);
+    out += "# TYPE budget_page_cache_bytes gauge\n";
+    out += std::format("budget_page_cache_bytes {}\n", cache.bytes);
+
+    return out;
+}
@@ -0,0 +1,221 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "server_pool.hpp"
+
+#include "config.hpp"
+#include "http.hpp"
+#include "logging.hpp"
+#include "utils.hpp"
+
+using namespace budget;
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+std::atomic<size_t> pool_threads     = 0;
+std::atomic<size_t> pool_capacity    = 0;
+std::atomic<size_t> pool_queued      = 0;
+std::atomic<size_t> pool_active      = 0;
+std::atomic<size_t> pool_connections = 0;
+std::atomic<size_t> pool_rejected    = 0;
+std::atomic<size_t> pool_wait_total_us = 0;
+std::atomic<size_t> pool_wait_max_us   = 0;
+
+size_t default_threads() {
+    return std::max<size_t>(8, std::thread::hardware_concurrency());
+}
+
+void record_wait(clock_type::time_point queued) {
+    const auto wait = static_cast<size_t>(std::chrono::duration_cast<std::chrono::microseconds>(clock_type::now() - queued).count());
+
+    pool_wait_total_us += wait;
+
+    auto max = pool_wait_max_us.load();
+    while (wait > max && !pool_wait_max_us.compare_exchange_weak(max, wait)) {}
+}
+
+// Counts a served connection, even if it throws
+struct active_guard {
+    active_guard() {
+        ++pool_active;
+    }
+
+    ~active_guard() {
+        --pool_active;
+        ++pool_connections;
+    }
+
+    active_guard(const active_guard&)            = delete;
+    active_guard& operator=(const active_guard&) = delete;
+};
+
+struct server_pool : httplib::TaskQueue {
+    server_pool(size_t threads, size_t capacity, bool block) : capacity(capacity), block(block) {
+        pool_threads  = threads;
+        pool_capacity = capacity;
+
+        workers.reserve(threads);
+        for (size_t i = 0; i < threads; ++i) {
+            workers.emplace_back([this] { work(); });
+        }
+    }
+
+    bool enqueue(std::function<void()> fn) override {
+        {
+            std::unique_lock lk(lock);
+
+            if (capacity && tasks.size() >= capacity) {
+                if (!block) {
+                    ++pool_rejected;
+                    return false;
+                }
+
+                space.wait(lk, [this] { return stopping || tasks.size() < capacity; });
+            }
+
+            if (stopping) {
+                return false;
+            }
+
+            tasks.emplace_back(std::move(fn), clock_type::now());
+            pool_queued = tasks.size();
+        }
+
+        ready.notify_one();
+        return true;
+    }
+
+    void shutdown() override {
+        {
+            std::unique_lock lk(lock);
+            stopping = true;
+        }
+
+        ready.notify_all();
+        space.notify_all();
+
+        // The workers drain the queue before exiting
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        pool_threads = 0;
+    }
+
+private:
+    struct task {
+        std::function<void()>  fn;
+        clock_type::time_point queued;
+    };
+
+    void work() {
+        while (true) {
+            task next;
+
+            {
+                std::unique_lock lk(lock);
+                ready.wait(lk, [this] { return stopping || !tasks.empty(); });
+
+                if (tasks.empty()) {
+                    return;
+                }
+
+                next = std::move(tasks.front());
+                tasks.pop_front();
+                pool_queued = tasks.size();
+            }
+
+            space.notify_one();
+
+            record_wait(next.queued);
+
+            active_guard active;
+
+            // An escaping exception must not take the worker down
+            try {
+                next.fn();
+            } catch (const std::exception& e) {
+                LOG_F(ERROR, "Exception escaped from a server task: {}", e.what());
+            } catch (...) {
+                LOG_F(ERROR, "Unknown exception escaped from a server task");
+            }
+        }
+    }
+
+    const size_t capacity;
+    const bool   block;
+
+    std::vector<std::thread> workers;
+    std::deque<task>         tasks;
+    bool                     stopping = false;
+
+    std::mutex              lock;
+    std::condition_variable ready; // A task is available
+    std::condition_variable space; // A slot is available in the queue
+};
+
+httplib::TaskQueue* make_server_pool() {
+    auto threads = to_number<size_t>(config_value("server_threads", std::to_string(default_threads())));
+    auto depth   = to_number<size_t>(config_value("server_queue_depth", "0"));
+    auto policy  = config_value("server_queue_policy", "reject");
+
+    if (!threads) {
+        threads = default_threads();
+    }
+
+    if (policy != "reject" && policy != "block") {
+        LOG_F(WARNING, "Invalid server_queue_policy {}, using reject", policy);
+        policy = "reject";
+    }
+
+    LOG_F(INFO, "Server pool: {} threads, queue depth {}, policy {}", threads, depth, policy);
+
+    return new server_pool(threads, depth, policy == "block");
+}
+
+} // end of anonymous namespace
+
+void budget::configure_server_pool(httplib::Server& server) {
+    // An idle keep-alive connection holds its worker until the timeout
+    const auto timeout   = to_number<size_t>(config_value("server_keep_alive_timeout", std::to_string(CPPHTTPLIB_KEEPALIVE_TIMEOUT_SECOND)));
+    const auto max_count = to_number<size_t>(config_value("server_keep_alive_max_count", std::to_string(CPPHTTPLIB_KEEPALIVE_MAX_COUNT)));
+
+    LOG_F(INFO, "Server keep-alive: {}s timeout, {} requests per connection", timeout, max_count);
+
+    server.set_keep_alive_timeout(static_cast<time_t>(timeout));
+    server.set_keep_alive_max_count(max_count);
+
+    server.new_task_queue = [] { return make_server_pool(); };
+}
+
+server_pool_stats budget::get_server_pool_stats() {
+    server_pool_stats stats;
+
+    stats.threads       = pool_threads;
+    stats.capacity      = pool_capacity;
+    stats.queued        = pool_queued;
+    stats.active        = pool_active;
+    stats.connections   = pool_connections;
+    stats.rejected      = pool_rejected;
+    stats.wait_total_us = pool_wait_total_us;
+    stats.wait_max_us   = pool_wait_max_us;
+
+    return stats;
+}